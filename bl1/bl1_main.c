@@ -156,6 +156,7 @@ void bl1_main(void)
 	bl1_prepare_next_image(image_id);
 
 	console_flush();
+	tf_log_bin_flush();
 }
 
 /*******************************************************************************
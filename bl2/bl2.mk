@@ -8,9 +8,16 @@ BL2_SOURCES		+=	bl2/bl2_image_load_v2.c			\
 				bl2/bl2_main.c				\
 				bl2/${ARCH}/bl2_arch_setup.c		\
 				lib/locks/exclusive/${ARCH}/spinlock.S	\
-				plat/common/${ARCH}/platform_up_stack.S	\
 				${MBEDTLS_SOURCES}
 
+# The secondary CPU hashing the images needs a stack of its own
+ifeq (${BL2_PARALLEL_HASH},1)
+BL2_SOURCES		+=	bl2/bl2_par_hash.c			\
+				plat/common/${ARCH}/platform_mp_stack.S
+else
+BL2_SOURCES		+=	plat/common/${ARCH}/platform_up_stack.S
+endif
+
 ifeq (${ARCH},aarch64)
 BL2_SOURCES		+=	common/aarch64/early_exceptions.S
 endif
@@ -93,9 +93,18 @@ void bl2_main(void)
 	/* initialize boot source */
 	bl2_plat_preload_setup();
 
+#if BL2_PARALLEL_HASH
+	/* Release a secondary CPU to hash the images while they are loaded */
+	bl2_par_hash_init();
+#endif
+
 	/* Load the subsequent bootloader images. */
 	next_bl_ep_info = bl2_load_images();
 
+#if BL2_PARALLEL_HASH
+	bl2_par_hash_exit();
+#endif
+
 #if !BL2_AT_EL3
 #ifndef __aarch64__
 	/*
@@ -107,6 +116,7 @@ void bl2_main(void)
 #endif /* !__aarch64__ */
 
 	console_flush();
+	tf_log_bin_flush();
 
 #if ENABLE_PAUTH
 	/*
@@ -125,6 +135,7 @@ void bl2_main(void)
 	NOTICE("BL2: Booting " NEXT_IMAGE "\n");
 	print_entry_point_info(next_bl_ep_info);
 	console_flush();
+	tf_log_bin_flush();
 
 #if ENABLE_PAUTH
 	/*
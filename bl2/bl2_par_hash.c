@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2020, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <platform_def.h>
+
+#include <arch_helpers.h>
+#include <bl2/bl2.h>
+#include <common/debug.h>
+#include <drivers/auth/auth_mod.h>
+#include <lib/cassert.h>
+#include <lib/utils_def.h>
+#include <plat/common/platform.h>
+
+/*
+ * With BL2_PARALLEL_HASH, the chunks of an image that load_image() reads are
+ * hashed by a secondary CPU while the primary CPU reads the next ones. The
+ * primary CPU is the only producer of the queue and the secondary CPU its only
+ * consumer, so the queue only needs the ordering of the 'head' and 'tail'
+ * counters. The hash calculation itself is only ever accessed by one CPU at a
+ * time, as the primary CPU waits for the queue to be empty before using it.
+ */
+#define BL2_PAR_HASH_QUEUE_LEN	U(8)
+
+CASSERT(IS_POWER_OF_TWO(BL2_PAR_HASH_QUEUE_LEN),
+	assert_bl2_par_hash_queue_len_power_of_two);
+
+typedef struct bl2_par_hash_chunk {
+	uintptr_t base;
+	unsigned int len;
+} bl2_par_hash_chunk_t;
+
+static struct {
+	bl2_par_hash_chunk_t chunks[BL2_PAR_HASH_QUEUE_LEN];
+	unsigned int head;	/* Written by the primary CPU */
+	unsigned int tail;	/* Written by the secondary CPU */
+	bool released;		/* A secondary CPU has been released */
+	bool ready;		/* The secondary CPU consumes the queue */
+	bool stop;		/* The secondary CPU must go back to its pen */
+	bool parked;		/* The secondary CPU is back to its pen */
+} __aligned(CACHE_WRITEBACK_GRANULE) bl2_par_hash;
+
+void bl2_par_hash_init(void)
+{
+	if (bl2_el3_plat_release_secondary(
+			(uintptr_t)bl2_par_hash_entrypoint) != 0) {
+		INFO("BL2: Images are hashed by the primary CPU\n");
+		return;
+	}
+
+	bl2_par_hash.released = true;
+}
+
+void bl2_par_hash_update(void *ptr, unsigned int len)
+{
+	unsigned int head = bl2_par_hash.head;
+
+	/*
+	 * Until the secondary CPU has come up, hash the chunk straight away.
+	 * The queue is necessarily empty then, so the order is kept.
+	 */
+	if (!__atomic_load_n(&bl2_par_hash.ready, __ATOMIC_ACQUIRE)) {
+		auth_mod_hash_update(ptr, len);
+		return;
+	}
+
+	while ((head - __atomic_load_n(&bl2_par_hash.tail, __ATOMIC_ACQUIRE)) ==
+	       BL2_PAR_HASH_QUEUE_LEN) {
+		wfe();
+	}
+
+	bl2_par_hash.chunks[head & (BL2_PAR_HASH_QUEUE_LEN - 1U)] =
+		(bl2_par_hash_chunk_t){ .base = (uintptr_t)ptr, .len = len };
+	__atomic_store_n(&bl2_par_hash.head, head + 1U, __ATOMIC_RELEASE);
+	dsbish();
+	sev();
+}
+
+void bl2_par_hash_wait(void)
+{
+	while (__atomic_load_n(&bl2_par_hash.tail, __ATOMIC_ACQUIRE) !=
+	       bl2_par_hash.head) {
+		wfe();
+	}
+}
+
+void bl2_par_hash_exit(void)
+{
+	if (!bl2_par_hash.released) {
+		return;
+	}
+
+	bl2_par_hash_wait();
+
+	/*
+	 * The secondary CPU runs BL2 code until it is back in its pen, so it
+	 * must get there before the next image is run.
+	 */
+	__atomic_store_n(&bl2_par_hash.stop, true, __ATOMIC_RELEASE);
+	dsbish();
+	sev();
+
+	while (!__atomic_load_n(&bl2_par_hash.parked, __ATOMIC_ACQUIRE)) {
+		wfe();
+	}
+}
+
+void __dead2 bl2_par_hash_worker(void)
+{
+	unsigned int tail = bl2_par_hash.tail;
+	bl2_par_hash_chunk_t chunk;
+
+	__atomic_store_n(&bl2_par_hash.ready, true, __ATOMIC_RELEASE);
+
+	for (;;) {
+		if (tail == __atomic_load_n(&bl2_par_hash.head,
+					    __ATOMIC_ACQUIRE)) {
+			if (__atomic_load_n(&bl2_par_hash.stop,
+					    __ATOMIC_ACQUIRE)) {
+				break;
+			}
+			wfe();
+			continue;
+		}
+
+		chunk = bl2_par_hash.chunks[tail & (BL2_PAR_HASH_QUEUE_LEN - 1U)];
+		auth_mod_hash_update((void *)chunk.base, chunk.len);
+
+		tail++;
+		__atomic_store_n(&bl2_par_hash.tail, tail, __ATOMIC_RELEASE);
+		dsbish();
+		sev();
+	}
+
+	/*
+	 * From here on, this CPU doesn't access any data of BL2, it only runs
+	 * bl2_par_hash_park() and the holding pen of the platform.
+	 */
+	__atomic_store_n(&bl2_par_hash.parked, true, __ATOMIC_RELEASE);
+	dsbish();
+	sev();
+
+	bl2_par_hash_park();
+}
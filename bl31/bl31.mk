@@ -43,6 +43,14 @@ ifeq (${ENABLE_PMF}, 1)
 BL31_SOURCES		+=	lib/pmf/pmf_main.c
 endif
 
+ifeq (${ENABLE_CONSOLE_RING}, 1)
+BL31_SOURCES		+=	drivers/console/console_ring.c
+endif
+
+ifeq (${ENABLE_SMC_LATENCY_STATS}, 1)
+BL31_SOURCES		+=	lib/pmf/pmf_smc_latency.c
+endif
+
 ifeq (${EL3_EXCEPTION_HANDLING},1)
 BL31_SOURCES		+=	bl31/ehf.c
 endif
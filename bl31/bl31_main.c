@@ -141,6 +141,7 @@ void bl31_main(void)
 	bl31_prepare_next_image_entry();
 
 	console_flush();
+	tf_log_bin_flush();
 
 	/*
 	 * Perform any platform specific runtime setup prior to cold boot exit
@@ -1,16 +1,20 @@
 /*
- * Copyright (c) 2013-2019, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2013-2020, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
 #include <assert.h>
 #include <errno.h>
+#include <stdbool.h>
 #include <string.h>
 
+#include <platform_def.h>
+
 #include <arch.h>
 #include <arch_features.h>
 #include <arch_helpers.h>
+#include <bl2/bl2.h>
 #include <common/bl_common.h>
 #include <common/debug.h>
 #include <drivers/auth/auth_mod.h>
@@ -47,6 +51,15 @@ static int dyn_is_auth_disabled(void)
 }
 #endif /* TRUSTED_BOARD_BOOT */
 
+/*
+ * Images are read from storage in chunks of this size so that the per-chunk
+ * processing (e.g. cache maintenance) is done while the data is still in the
+ * cache, rather than in a separate pass over the whole image.
+ */
+#ifndef PLAT_IMAGE_LOAD_CHUNK_SIZE
+#define PLAT_IMAGE_LOAD_CHUNK_SIZE	(64U * 1024U)
+#endif
+
 uintptr_t page_align(uintptr_t value, unsigned dir)
 {
 	/* Round up the limit to the next page boundary */
@@ -63,17 +76,25 @@ uintptr_t page_align(uintptr_t value, unsigned dir)
  * Internal function to load an image at a specific address given
  * an image ID and extents of free memory.
  *
+ * The image is read in chunks of PLAT_IMAGE_LOAD_CHUNK_SIZE bytes. If 'hash'
+ * is true, each chunk is passed to the hash started by auth_mod_hash_start()
+ * as soon as it has been read, and then, if 'flush' is true, flushed out to
+ * main memory while it is still in the cache.
+ *
  * If the load is successful then the image information is updated.
  *
  * Returns 0 on success, a negative error code otherwise.
  ******************************************************************************/
-static int load_image(unsigned int image_id, image_info_t *image_data)
+static int load_image(unsigned int image_id, image_info_t *image_data,
+		      bool flush, bool hash)
 {
 	uintptr_t dev_handle;
 	uintptr_t image_handle;
 	uintptr_t image_spec;
 	uintptr_t image_base;
 	size_t image_size;
+	size_t offset;
+	size_t chunk_size;
 	size_t bytes_read;
 	int io_result;
 
@@ -124,16 +145,48 @@ static int load_image(unsigned int image_id, image_info_t *image_data)
 
 	/* We have enough space so load the image now */
 	/* TODO: Consider whether to try to recover/retry a partially successful read */
-	io_result = io_read(image_handle, image_base, image_size, &bytes_read);
-	if ((io_result != 0) || (bytes_read < image_size)) {
-		WARN("Failed to load image id=%u (%i)\n", image_id, io_result);
-		goto exit;
+	for (offset = 0U; offset < image_size; offset += chunk_size) {
+		chunk_size = image_size - offset;
+		if (chunk_size > PLAT_IMAGE_LOAD_CHUNK_SIZE) {
+			chunk_size = PLAT_IMAGE_LOAD_CHUNK_SIZE;
+		}
+
+		io_result = io_read(image_handle, image_base + offset,
+				    chunk_size, &bytes_read);
+		if ((io_result != 0) || (bytes_read < chunk_size)) {
+			WARN("Failed to load image id=%u (%i)\n", image_id,
+			     io_result);
+			goto exit;
+		}
+
+#if TRUSTED_BOARD_BOOT
+		if (hash) {
+#if BL2_PARALLEL_HASH && defined(IMAGE_BL2)
+			bl2_par_hash_update((void *)(image_base + offset),
+					    (unsigned int)chunk_size);
+#else
+			auth_mod_hash_update((void *)(image_base + offset),
+					     (unsigned int)chunk_size);
+#endif
+		}
+#endif
+
+		if (flush) {
+			flush_dcache_range(image_base + offset, chunk_size);
+		}
 	}
 
 	INFO("Image id=%u loaded: 0x%lx - 0x%lx\n", image_id, image_base,
 	     (uintptr_t)(image_base + image_size));
 
 exit:
+#if BL2_PARALLEL_HASH && defined(IMAGE_BL2)
+	/* The hash must be complete, or idle if it is abandoned */
+	if (hash) {
+		bl2_par_hash_wait();
+	}
+#endif
+
 	(void)io_close(image_handle);
 	/* Ignore improbable/unrecoverable error in 'close' */
 
@@ -151,15 +204,7 @@ exit:
 static int load_image_flush(unsigned int image_id,
 			    image_info_t *image_data)
 {
-	int rc;
-
-	rc = load_image(image_id, image_data);
-	if (rc == 0) {
-		flush_dcache_range(image_data->image_base,
-				   image_data->image_size);
-	}
-
-	return rc;
+	return load_image(image_id, image_data, true, false);
 }
 
 
@@ -174,6 +219,7 @@ static int load_auth_image_recursive(unsigned int image_id,
 {
 	int rc;
 	unsigned int parent_id;
+	bool hash;
 
 	/* Use recursion to authenticate parent images */
 	rc = auth_mod_get_parent_id(image_id, &parent_id);
@@ -184,9 +230,27 @@ static int load_auth_image_recursive(unsigned int image_id,
 		}
 	}
 
-	/* Load the image */
-	rc = load_image(image_id, image_data);
+	/*
+	 * If possible, hash the image as it is loaded rather than in a
+	 * separate pass when it is authenticated.
+	 */
+	hash = (auth_mod_hash_start(image_id) == 0);
+
+	/*
+	 * Load the image. Child images are flushed to main memory so that they
+	 * can be executed later by any CPU, regardless of cache and MMU state.
+	 * This is not needed for the parents (certificates). The image is
+	 * flushed as it is loaded if it is also hashed then, and otherwise
+	 * once it has been hashed and authenticated, so that it is still in the
+	 * cache when it is hashed.
+	 */
+	rc = load_image(image_id, image_data, (is_parent_image == 0) && hash,
+			hash);
 	if (rc != 0) {
+		/* Don't leave a partial hash behind, e.g. for a retry */
+		if (hash) {
+			auth_mod_hash_abort();
+		}
 		return rc;
 	}
 
@@ -203,12 +267,7 @@ static int load_auth_image_recursive(unsigned int image_id,
 		return -EAUTH;
 	}
 
-	/*
-	 * Flush the image to main memory so that it can be executed later by
-	 * any CPU, regardless of cache and MMU state. This is only needed for
-	 * child images, not for the parents (certificates).
-	 */
-	if (is_parent_image == 0) {
+	if ((is_parent_image == 0) && !hash) {
 		flush_dcache_range(image_data->image_base,
 				   image_data->image_size);
 	}
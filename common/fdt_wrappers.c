@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2018-2020, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -7,12 +7,369 @@
 /* Helper functions to offer easier navigation of Device Tree Blob */
 
 #include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
 #include <string.h>
 
 #include <libfdt.h>
 
 #include <common/debug.h>
 #include <common/fdt_wrappers.h>
+#include <lib/utils_def.h>
+
+/*
+ * The index is a hash table of the nodes, properties and compatible strings of
+ * a DTB, which maps:
+ *  - the offset of a node and the name of one of its subnodes, without its unit
+ *    address, to the offset of the subnode,
+ *  - the offset of a node and the name of one of its properties to the offset
+ *    of the property,
+ *  - each string of a "compatible" property to the offset of its node.
+ * The kind of key is mixed into the hash. Collisions are resolved by linear
+ * probing, and the candidates are checked against the DTB itself.
+ */
+#define FDTW_KEY_SUBNODE	U(1)
+#define FDTW_KEY_PROP		U(2)
+#define FDTW_KEY_COMPAT		U(3)
+
+/* Maximum depth of the nodes of an indexed DTB */
+#define FDTW_INDEX_MAX_DEPTH	32
+
+typedef struct fdtw_index_entry {
+	uint32_t hash;		/* Zero for an empty slot */
+	int32_t key;		/* Parent node, node or -1 for compatibles */
+	int32_t offset;		/* Offset of the subnode, property or node */
+} fdtw_index_entry_t;
+
+typedef struct fdtw_index {
+	const void *dtb;
+	uint32_t struct_size;	/* To detect DTBs changed after indexing */
+	uint32_t nr_slots;
+	uint32_t nr_entries;
+	fdtw_index_entry_t slots[];
+} fdtw_index_t;
+
+static fdtw_index_t *fdtw_index;
+
+static inline uint32_t fdtw_next_slot(const fdtw_index_t *index, uint32_t i)
+{
+	return ((i + 1U) < index->nr_slots) ? (i + 1U) : 0U;
+}
+
+static uint32_t fdtw_hash(uint32_t kind, int key, const char *str, size_t len)
+{
+	uint32_t hash = 2166136261U ^ kind;	/* FNV-1a */
+	size_t i;
+
+	hash = (hash ^ (uint32_t)key) * 16777619U;
+	for (i = 0U; i < len; i++) {
+		hash = (hash ^ (uint8_t)str[i]) * 16777619U;
+	}
+
+	return (hash != 0U) ? hash : 1U;
+}
+
+static int fdtw_index_add(fdtw_index_t *index, uint32_t hash, int key,
+			  int offset)
+{
+	uint32_t i;
+
+	/* Keep a quarter of the slots empty so that the probes stay short */
+	if (((index->nr_entries + 1U) * 4U) > (index->nr_slots * 3U)) {
+		return -1;
+	}
+
+	for (i = hash % index->nr_slots; index->slots[i].hash != 0U;
+	     i = fdtw_next_slot(index, i))
+		;
+
+	index->slots[i].hash = hash;
+	index->slots[i].key = key;
+	index->slots[i].offset = offset;
+	index->nr_entries++;
+
+	return 0;
+}
+
+static int fdtw_index_node(fdtw_index_t *index, int node, int parent)
+{
+	const char *name, *value, *at;
+	int prop, len, ret = 0;
+
+	if (parent >= 0) {
+		name = fdt_get_name(index->dtb, node, &len);
+		if (name == NULL) {
+			return -1;
+		}
+
+		at = memchr(name, '@', (size_t)len);
+		if (at != NULL) {
+			len = (int)(at - name);
+		}
+
+		ret |= fdtw_index_add(index, fdtw_hash(FDTW_KEY_SUBNODE,
+				      parent, name, (size_t)len), parent, node);
+	}
+
+	fdt_for_each_property_offset(prop, index->dtb, node) {
+		value = fdt_getprop_by_offset(index->dtb, prop, &name, &len);
+		if (value == NULL) {
+			return -1;
+		}
+
+		ret |= fdtw_index_add(index, fdtw_hash(FDTW_KEY_PROP, node,
+				      name, strlen(name)), node, prop);
+
+		if (strcmp(name, "compatible") != 0) {
+			continue;
+		}
+
+		/* Index each string of the list */
+		while (len > 0) {
+			size_t slen = strnlen(value, (size_t)len);
+
+			ret |= fdtw_index_add(index, fdtw_hash(FDTW_KEY_COMPAT,
+					      -1, value, slen), -1, node);
+			value += slen + 1U;
+			len -= (int)slen + 1;
+		}
+	}
+
+	return ret;
+}
+
+/*
+ * Build the index of a DTB in the 'size' bytes of memory at 'arena', which must
+ * remain valid as long as the index is in use. There is a key for each node,
+ * property and compatible string. As a hash slot is 12 bytes long and a quarter
+ * of the slots are kept empty, an arena of 64 bytes plus 16 bytes per key is
+ * large enough. Once built, the fdtw_* helpers use the index for this DTB until
+ * it is replaced by another one or cleared with fdtw_index_clear(). The index
+ * remains valid when properties are changed in place but must be built again if
+ * nodes or properties are added, removed or resized. Returns 0 on success, and
+ * -1 upon error, in which case the helpers walk the DTB instead.
+ */
+int fdtw_index_init(const void *dtb, void *arena, size_t size)
+{
+	fdtw_index_t *index = arena;
+	int parents[FDTW_INDEX_MAX_DEPTH];
+	int node, depth = 0;
+	uint32_t nr_slots;
+
+	assert(dtb != NULL);
+	assert(arena != NULL);
+	assert(((uintptr_t)arena % sizeof(uint64_t)) == 0U);
+
+	fdtw_index = NULL;
+
+	if (size < sizeof(fdtw_index_t)) {
+		return -1;
+	}
+
+	size = (size - sizeof(fdtw_index_t)) / sizeof(fdtw_index_entry_t);
+	if ((size < 4U) || (size > UINT32_MAX)) {
+		return -1;
+	}
+	nr_slots = (uint32_t)size;
+
+	index->dtb = dtb;
+	index->struct_size = fdt_size_dt_struct(dtb);
+	index->nr_slots = nr_slots;
+	index->nr_entries = 0U;
+	(void)memset(index->slots, 0, nr_slots * sizeof(fdtw_index_entry_t));
+
+	/* The depth becomes negative after the end of the root node */
+	for (node = 0; (node >= 0) && (depth >= 0);
+	     node = fdt_next_node(dtb, node, &depth)) {
+		if (depth >= FDTW_INDEX_MAX_DEPTH) {
+			WARN("DTB too deep to be indexed\n");
+			return -1;
+		}
+
+		parents[depth] = node;
+		if (fdtw_index_node(index, node,
+				    (depth > 0) ? parents[depth - 1] : -1) != 0) {
+			WARN("Not enough space to index the DTB\n");
+			return -1;
+		}
+	}
+
+	if ((node < 0) && (node != -FDT_ERR_NOTFOUND)) {
+		WARN("Cannot index the DTB: error %d\n", node);
+		return -1;
+	}
+
+	VERBOSE("Indexed DTB %p with %u keys\n", dtb, index->nr_entries);
+	fdtw_index = index;
+
+	return 0;
+}
+
+void fdtw_index_clear(void)
+{
+	fdtw_index = NULL;
+}
+
+static const fdtw_index_t *fdtw_get_index(const void *dtb)
+{
+	if ((fdtw_index == NULL) || (fdtw_index->dtb != dtb) ||
+	    (fdt_size_dt_struct(dtb) != fdtw_index->struct_size)) {
+		return NULL;
+	}
+
+	return fdtw_index;
+}
+
+/*
+ * Get a property of a node like fdt_getprop() does, but using the index if
+ * there is one for this DTB.
+ */
+static const void *fdtw_getprop(const void *dtb, int node, const char *prop,
+				int *lenp)
+{
+	const fdtw_index_t *index = fdtw_get_index(dtb);
+	const void *value;
+	const char *name;
+	uint32_t hash, i;
+
+	if (index == NULL) {
+		return fdt_getprop_namelen(dtb, node, prop, (int)strlen(prop),
+					   lenp);
+	}
+
+	hash = fdtw_hash(FDTW_KEY_PROP, node, prop, strlen(prop));
+	for (i = hash % index->nr_slots; index->slots[i].hash != 0U;
+	     i = fdtw_next_slot(index, i)) {
+		if ((index->slots[i].hash != hash) ||
+		    (index->slots[i].key != node)) {
+			continue;
+		}
+
+		value = fdt_getprop_by_offset(dtb, index->slots[i].offset,
+					      &name, lenp);
+		if ((value != NULL) && (strcmp(name, prop) == 0)) {
+			return value;
+		}
+	}
+
+	return NULL;
+}
+
+/*
+ * Find the first node after 'startoffset' which is compatible with
+ * 'compatible', like fdt_node_offset_by_compatible() does, but using the index
+ * if there is one for this DTB.
+ */
+int fdtw_node_offset_by_compatible(const void *dtb, int startoffset,
+				   const char *compatible)
+{
+	const fdtw_index_t *index = fdtw_get_index(dtb);
+	uint32_t hash, i;
+	int node = -FDT_ERR_NOTFOUND;
+
+	assert(compatible != NULL);
+
+	if (index == NULL) {
+		return fdt_node_offset_by_compatible(dtb, startoffset,
+						     compatible);
+	}
+
+	hash = fdtw_hash(FDTW_KEY_COMPAT, -1, compatible, strlen(compatible));
+	for (i = hash % index->nr_slots; index->slots[i].hash != 0U;
+	     i = fdtw_next_slot(index, i)) {
+		int offset = index->slots[i].offset;
+
+		if ((index->slots[i].hash != hash) || (offset <= startoffset) ||
+		    ((node >= 0) && (offset >= node))) {
+			continue;
+		}
+
+		if (fdt_node_check_compatible(dtb, offset, compatible) == 0) {
+			node = offset;
+		}
+	}
+
+	return node;
+}
+
+/* Same as the static fdt_nodename_eq_() of libfdt */
+static bool fdtw_nodename_eq(const void *dtb, int node, const char *name,
+			     int len)
+{
+	const char *p = fdt_get_name(dtb, node, NULL);
+
+	if ((p == NULL) || (strncmp(p, name, (size_t)len) != 0)) {
+		return false;
+	}
+
+	return (p[len] == '\0') ||
+		((memchr(name, '@', (size_t)len) == NULL) && (p[len] == '@'));
+}
+
+/*
+ * Find the node of a path like fdt_path_offset() does, but using the index if
+ * there is one for this DTB. Aliases are resolved by libfdt.
+ */
+int fdtw_path_offset(const void *dtb, const char *path)
+{
+	const fdtw_index_t *index = fdtw_get_index(dtb);
+	const char *end, *at;
+	uint32_t hash, i;
+	int node = 0, subnode, len;
+
+	assert(path != NULL);
+
+	if ((index == NULL) || (path[0] != '/')) {
+		return fdt_path_offset(dtb, path);
+	}
+
+	while (*path != '\0') {
+		while (*path == '/') {
+			path++;
+		}
+		if (*path == '\0') {
+			break;
+		}
+
+		end = strchr(path, '/');
+		if (end == NULL) {
+			end = path + strlen(path);
+		}
+		len = (int)(end - path);
+
+		/* Subnodes are indexed without their unit address */
+		at = memchr(path, '@', (size_t)len);
+		hash = fdtw_hash(FDTW_KEY_SUBNODE, node, path,
+				 (at != NULL) ? (size_t)(at - path) :
+						(size_t)len);
+
+		/* Take the first matching subnode, as libfdt does */
+		subnode = -FDT_ERR_NOTFOUND;
+		for (i = hash % index->nr_slots; index->slots[i].hash != 0U;
+		     i = fdtw_next_slot(index, i)) {
+			int offset = index->slots[i].offset;
+
+			if ((index->slots[i].hash != hash) ||
+			    (index->slots[i].key != node) ||
+			    ((subnode >= 0) && (offset >= subnode))) {
+				continue;
+			}
+
+			if (fdtw_nodename_eq(dtb, offset, path, len)) {
+				subnode = offset;
+			}
+		}
+
+		if (subnode < 0) {
+			return subnode;
+		}
+
+		node = subnode;
+		path = end;
+	}
+
+	return node;
+}
 
 /*
  * Read cells from a given property of the given node. At most 2 cells of the
@@ -35,8 +392,7 @@ int fdtw_read_cells(const void *dtb, int node, const char *prop,
 	assert(cells <= 2U);
 
 	/* Access property and obtain its length (in bytes) */
-	value_ptr = fdt_getprop_namelen(dtb, node, prop, (int)strlen(prop),
-			&value_len);
+	value_ptr = fdtw_getprop(dtb, node, prop, &value_len);
 	if (value_ptr == NULL) {
 		WARN("Couldn't find property %s in dtb\n", prop);
 		return -1;
@@ -80,8 +436,7 @@ int fdtw_read_array(const void *dtb, int node, const char *prop,
 	assert(node >= 0);
 
 	/* Access property and obtain its length (in bytes) */
-	value_ptr = fdt_getprop_namelen(dtb, node, prop, (int)strlen(prop),
-			&value_len);
+	value_ptr = fdtw_getprop(dtb, node, prop, &value_len);
 	if (value_ptr == NULL) {
 		WARN("Couldn't find property %s in dtb\n", prop);
 		return -1;
@@ -119,7 +474,7 @@ int fdtw_read_string(const void *dtb, int node, const char *prop,
 	assert(str != NULL);
 	assert(size > 0U);
 
-	ptr = fdt_getprop_namelen(dtb, node, prop, (int)strlen(prop), NULL);
+	ptr = fdtw_getprop(dtb, node, prop, NULL);
 	if (ptr == NULL) {
 		WARN("Couldn't find property %s in dtb\n", prop);
 		return -1;
@@ -141,7 +496,8 @@ int fdtw_read_string(const void *dtb, int node, const char *prop,
 int fdtw_write_inplace_cells(void *dtb, int node, const char *prop,
 		unsigned int cells, void *value)
 {
-	int err, len;
+	void *ptr;
+	int err, len, prop_len;
 
 	assert(dtb != NULL);
 	assert(prop != NULL);
@@ -159,7 +515,19 @@ int fdtw_write_inplace_cells(void *dtb, int node, const char *prop,
 	len = (int)cells * 4;
 
 	/* Set property value in place */
-	err = fdt_setprop_inplace(dtb, node, prop, value, len);
+	if (fdtw_get_index(dtb) == NULL) {
+		err = fdt_setprop_inplace(dtb, node, prop, value, len);
+	} else {
+		ptr = (void *)fdtw_getprop(dtb, node, prop, &prop_len);
+		if (ptr == NULL) {
+			err = -FDT_ERR_NOTFOUND;
+		} else if (prop_len != len) {
+			err = -FDT_ERR_NOSPACE;
+		} else {
+			(void)memcpy(ptr, value, (size_t)len);
+			err = 0;
+		}
+	}
 	if (err != 0) {
 		WARN("Modify property %s failed with error %d\n", prop, err);
 		return -1;
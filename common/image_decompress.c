@@ -1,11 +1,13 @@
 /*
- * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2018-2020, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
 #include <assert.h>
+#include <errno.h>
 #include <stdint.h>
+#include <string.h>
 
 #include <arch_helpers.h>
 #include <common/bl_common.h>
@@ -17,12 +19,64 @@ static uint32_t decompressor_buf_size;
 static decompressor_t *decompressor;
 static struct image_info saved_image_info;
 
+#define IMAGE_DECOMPRESS_MAX_FORMATS	4U
+
+static struct decompress_format {
+	const uint8_t *magic;
+	size_t magic_len;
+	decompressor_t *decompressor;
+} formats[IMAGE_DECOMPRESS_MAX_FORMATS];
+static unsigned int formats_num;
+
+/*
+ * 'decompressor' decompresses the images which don't match any of the formats
+ * added by image_decompress_add_format(). It may be NULL if formats are added.
+ */
 void image_decompress_init(uintptr_t buf_base, uint32_t buf_size,
 			   decompressor_t *_decompressor)
 {
 	decompressor_buf_base = buf_base;
 	decompressor_buf_size = buf_size;
 	decompressor = _decompressor;
+	formats_num = 0U;
+}
+
+/*
+ * Decompress the images whose compressed data starts with 'magic' with
+ * 'decompressor'. The decompressor of each image is selected from its data,
+ * so that each image can be compressed with the format that suits it best.
+ */
+int image_decompress_add_format(const uint8_t *magic, size_t magic_len,
+				decompressor_t *_decompressor)
+{
+	assert((magic != NULL) && (magic_len != 0U));
+	assert(_decompressor != NULL);
+
+	if (formats_num == IMAGE_DECOMPRESS_MAX_FORMATS) {
+		return -ENOMEM;
+	}
+
+	formats[formats_num].magic = magic;
+	formats[formats_num].magic_len = magic_len;
+	formats[formats_num].decompressor = _decompressor;
+	formats_num++;
+
+	return 0;
+}
+
+static decompressor_t *image_decompress_select(uintptr_t buf, size_t len)
+{
+	unsigned int i;
+
+	for (i = 0U; i < formats_num; i++) {
+		if ((len >= formats[i].magic_len) &&
+		    (memcmp((const void *)buf, formats[i].magic,
+			    formats[i].magic_len) == 0)) {
+			return formats[i].decompressor;
+		}
+	}
+
+	return decompressor;
 }
 
 void image_decompress_prepare(struct image_info *info)
@@ -42,6 +96,7 @@ int image_decompress(struct image_info *info)
 {
 	uintptr_t compressed_image_base, image_base, work_base;
 	uint32_t compressed_image_size, work_size;
+	decompressor_t *image_decompressor;
 	int ret;
 
 	/*
@@ -63,9 +118,16 @@ int image_decompress(struct image_info *info)
 	work_base = compressed_image_base + compressed_image_size;
 	work_size = decompressor_buf_size - compressed_image_size;
 
-	ret = decompressor(&compressed_image_base, compressed_image_size,
-			   &image_base, info->image_max_size,
-			   work_base, work_size);
+	image_decompressor = image_decompress_select(compressed_image_base,
+						     compressed_image_size);
+	if (image_decompressor == NULL) {
+		ERROR("Unknown compression format\n");
+		return -EINVAL;
+	}
+
+	ret = image_decompressor(&compressed_image_base, compressed_image_size,
+				 &image_base, info->image_max_size,
+				 work_base, work_size);
 	if (ret) {
 		ERROR("Failed to decompress image (err=%d)\n", ret);
 		return ret;
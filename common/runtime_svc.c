@@ -25,6 +25,20 @@ uint8_t rt_svc_descs_indices[MAX_RT_SVCS];
 #define RT_SVC_DECS_NUM		((RT_SVC_DESCS_END - RT_SVC_DESCS_START)\
 					/ sizeof(rt_svc_desc_t))
 
+#if ENABLE_SMC_FAST_PATH
+/*******************************************************************************
+ * The 'rt_svc_fast_fns' table holds the fast path handlers exported by services
+ * for individual function IDs by placing them in the 'rt_svc_fast_fns' linker
+ * section. When a fast SMC arrives, its function ID is hashed to get a slot of
+ * the table. If the slot holds the same function ID, its handler is called
+ * directly instead of the handler found through 'rt_svc_descs_indices'.
+ ******************************************************************************/
+rt_svc_fast_fn_t rt_svc_fast_fns[RT_SVC_FAST_FN_SLOTS];
+
+#define RT_SVC_FAST_FNS_NUM	((RT_SVC_FAST_FNS_END - RT_SVC_FAST_FNS_START)\
+					/ sizeof(rt_svc_fast_fn_desc_t))
+#endif
+
 /*******************************************************************************
  * Function to invoke the registered `handle` corresponding to the smc_fid in
  * AArch32 mode.
@@ -80,6 +94,48 @@ static int32_t validate_rt_svc_desc(const rt_svc_desc_t *desc)
 	return 0;
 }
 
+#if ENABLE_SMC_FAST_PATH
+/*******************************************************************************
+ * This function fills the 'rt_svc_fast_fns' table with the fast path handlers
+ * of the function IDs whose runtime service has been initialised. A handler
+ * whose slot is already taken is dropped, its function ID being dispatched
+ * through its runtime service like the other function IDs.
+ ******************************************************************************/
+static void __init rt_svc_fast_fns_init(void)
+{
+	unsigned int index;
+	const rt_svc_fast_fn_desc_t *fast_fn_descs;
+
+	assert(RT_SVC_FAST_FNS_END >= RT_SVC_FAST_FNS_START);
+
+	fast_fn_descs = (const rt_svc_fast_fn_desc_t *) RT_SVC_FAST_FNS_START;
+	for (index = 0U; index < RT_SVC_FAST_FNS_NUM; index++) {
+		const rt_svc_fast_fn_desc_t *desc = &fast_fn_descs[index];
+		rt_svc_fast_fn_t *slot;
+
+		if (!is_valid_fast_smc(desc->smc_fid) || (desc->handle == NULL)) {
+			ERROR("Invalid fast path handler %s\n", desc->name);
+			panic();
+		}
+
+		/* Skip handlers of runtime services which failed to initialise */
+		if (rt_svc_descs_indices[get_unique_oen_from_smc_fid(desc->smc_fid)]
+		    >= RT_SVC_DECS_NUM)
+			continue;
+
+		slot = &rt_svc_fast_fns[get_fast_fn_slot_from_smc_fid(desc->smc_fid)];
+		if (slot->handle != NULL) {
+			WARN("Fast path handler %s collides with 0x%x\n",
+				desc->name, slot->smc_fid);
+			continue;
+		}
+
+		slot->smc_fid = desc->smc_fid;
+		slot->handle = desc->handle;
+	}
+}
+#endif /* ENABLE_SMC_FAST_PATH */
+
 /*******************************************************************************
  * This function calls the initialisation routine in the descriptor exported by
  * a runtime service. Once a descriptor has been validated, its start & end
@@ -151,4 +207,8 @@ void __init runtime_svc_init(void)
 		for (; start_idx <= end_idx; start_idx++)
 			rt_svc_descs_indices[start_idx] = index;
 	}
+
+#if ENABLE_SMC_FAST_PATH
+	rt_svc_fast_fns_init();
+#endif
 }
@@ -9,6 +9,9 @@
 #include <stdio.h>
 
 #include <common/debug.h>
+#if ENABLE_BINARY_LOG
+#include <common/tf_log_bin.h>
+#endif
 #include <plat/common/platform.h>
 
 /* Set the default maximum log level to the `LOG_LEVEL` build flag */
@@ -37,6 +40,16 @@ void tf_log(const char *fmt, ...)
 	if (log_level > max_log_level)
 		return;
 
+#if ENABLE_BINARY_LOG
+	va_start(args, fmt);
+	tf_log_bin(fmt, args);
+	va_end(args);
+
+	/* Errors are still printed, as they are usually followed by a panic */
+	if (log_level > LOG_LEVEL_ERROR)
+		return;
+#endif
+
 	prefix_str = plat_log_get_prefix(log_level);
 
 	while (*prefix_str != '\0') {
@@ -0,0 +1,285 @@
+/*
+ * Copyright (c) 2020, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <assert.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include <arch_helpers.h>
+#include <common/debug.h>
+#include <common/tf_log_bin.h>
+#include <lib/cassert.h>
+
+#if defined(IMAGE_BL1)
+#define TF_LOG_BIN_IMAGE	TF_LOG_BIN_IMAGE_BL1
+#elif defined(IMAGE_BL2)
+#define TF_LOG_BIN_IMAGE	TF_LOG_BIN_IMAGE_BL2
+#elif defined(IMAGE_BL2U)
+#define TF_LOG_BIN_IMAGE	TF_LOG_BIN_IMAGE_BL2U
+#elif defined(IMAGE_BL31)
+#define TF_LOG_BIN_IMAGE	TF_LOG_BIN_IMAGE_BL31
+#elif defined(IMAGE_BL32)
+#define TF_LOG_BIN_IMAGE	TF_LOG_BIN_IMAGE_BL32
+#else
+#error "Unknown image for the binary log"
+#endif
+
+/*
+ * The first image to run after a reset starts a new log. The next images
+ * append their records to it.
+ */
+#if defined(IMAGE_BL1) || (defined(IMAGE_BL2) && BL2_AT_EL3) ||	\
+	(defined(IMAGE_BL31) && RESET_TO_BL31) ||			\
+	(defined(IMAGE_BL32) && defined(RESET_TO_SP_MIN) && RESET_TO_SP_MIN)
+#define TF_LOG_BIN_FIRST_IMAGE	1
+#else
+#define TF_LOG_BIN_FIRST_IMAGE	0
+#endif
+
+#define TF_LOG_BIN_CAPACITY	\
+	(PLAT_TF_LOG_BIN_SIZE - (uint32_t)sizeof(tf_log_bin_hdr_t))
+
+CASSERT(PLAT_TF_LOG_BIN_SIZE > sizeof(tf_log_bin_hdr_t),
+	assert_tf_log_bin_size);
+
+/*
+ * The log lives in a platform provided region when the platform wants it to be
+ * shared by all its images, or in the memory of each image otherwise.
+ */
+#ifdef PLAT_TF_LOG_BIN_BASE
+#define tf_log_bin_hdr		((tf_log_bin_hdr_t *)PLAT_TF_LOG_BIN_BASE)
+#else
+static uint8_t tf_log_bin_buf[PLAT_TF_LOG_BIN_SIZE]
+	__aligned(CACHE_WRITEBACK_GRANULE);
+#define tf_log_bin_hdr		((tf_log_bin_hdr_t *)tf_log_bin_buf)
+#endif
+
+#define tf_log_bin_records						\
+	((uint8_t *)tf_log_bin_hdr + sizeof(tf_log_bin_hdr_t))
+
+/*
+ * Format strings are identified by their address relative to this symbol. Its
+ * value tells the decoder which image wrote a record.
+ */
+const uint32_t tf_log_bin_image = TF_LOG_BIN_IMAGE;
+
+static bool tf_log_bin_started;
+
+/*
+ * BL31 and BL32 can log from several CPUs at the same time. Exclusive accesses
+ * can only be used once the data cache is enabled, when the secondary CPUs may
+ * be running.
+ */
+static bool tf_log_bin_use_atomics(void)
+{
+#if defined(IMAGE_BL31) || defined(IMAGE_BL32)
+#ifdef __aarch64__
+	u_register_t sctlr = IS_IN_EL3() ? read_sctlr_el3() : read_sctlr_el1();
+#else
+	u_register_t sctlr = read_sctlr();
+#endif
+
+	return (sctlr & SCTLR_C_BIT) != 0U;
+#else
+	return false;
+#endif
+}
+
+static void tf_log_bin_start(void)
+{
+	tf_log_bin_hdr_t *hdr = tf_log_bin_hdr;
+
+	if ((TF_LOG_BIN_FIRST_IMAGE != 0) || (hdr->magic != TF_LOG_BIN_MAGIC) ||
+	    (hdr->version != TF_LOG_BIN_VERSION) ||
+	    (hdr->size != PLAT_TF_LOG_BIN_SIZE)) {
+		hdr->version = TF_LOG_BIN_VERSION;
+		hdr->size = PLAT_TF_LOG_BIN_SIZE;
+		hdr->used = 0U;
+		hdr->dropped = 0U;
+		hdr->reserved = 0U;
+		hdr->magic = TF_LOG_BIN_MAGIC;
+	}
+
+	tf_log_bin_started = true;
+}
+
+/*
+ * Reserve 'size' bytes of records. Return false and count a dropped record if
+ * the log is full.
+ */
+static bool tf_log_bin_reserve(uint32_t size, uint32_t *offset)
+{
+	tf_log_bin_hdr_t *hdr = tf_log_bin_hdr;
+	uint32_t used;
+
+	if (!tf_log_bin_use_atomics()) {
+		used = hdr->used;
+		if ((used > TF_LOG_BIN_CAPACITY) ||
+		    (size > (TF_LOG_BIN_CAPACITY - used))) {
+			hdr->dropped++;
+			return false;
+		}
+
+		hdr->used = used + size;
+		*offset = used;
+		return true;
+	}
+
+	used = __atomic_load_n(&hdr->used, __ATOMIC_RELAXED);
+	do {
+		if ((used > TF_LOG_BIN_CAPACITY) ||
+		    (size > (TF_LOG_BIN_CAPACITY - used))) {
+			(void)__atomic_fetch_add(&hdr->dropped, 1U,
+						 __ATOMIC_RELAXED);
+			return false;
+		}
+	} while (!__atomic_compare_exchange_n(&hdr->used, &used, used + size,
+					      true, __ATOMIC_RELAXED,
+					      __ATOMIC_RELAXED));
+
+	*offset = used;
+	return true;
+}
+
+/*
+ * Store 'size' bytes of 'val' in little-endian order. The log is always written
+ * one byte at a time, as it is not in Normal memory while the MMU is disabled.
+ */
+static uint8_t *tf_log_bin_put(uint8_t *rec, uint64_t val, unsigned int size)
+{
+	unsigned int i;
+
+	for (i = 0U; i < size; i++)
+		rec[i] = (uint8_t)(val >> (8U * i));
+
+	return rec + size;
+}
+
+/*
+ * Walk the conversion specifiers of 'fmt' the same way vprintf() does, and
+ * store their arguments at 'rec' if it isn't NULL. Return the size of the
+ * arguments in the record.
+ */
+static size_t tf_log_bin_args(const char *fmt, va_list *args, uint8_t *rec)
+{
+	size_t size = 0U;
+
+	for (; *fmt != '\0'; fmt++) {
+		unsigned int l_count = 0U;
+		const char *str;
+		uint64_t val;
+		size_t i, len;
+
+		if (*fmt != '%')
+			continue;
+
+		/* Skip the length and padding specifiers */
+		for (fmt++; ; fmt++) {
+			if (*fmt == 'l') {
+				l_count++;
+			} else if (*fmt == 'z') {
+				if (sizeof(size_t) == 8U)
+					l_count = 2U;
+			} else if (*fmt == '0') {
+				while ((fmt[1] >= '0') && (fmt[1] <= '9'))
+					fmt++;
+			} else {
+				break;
+			}
+		}
+
+		switch (*fmt) {
+		case 'i':
+		case 'd':
+			if (l_count > 1U)
+				val = (uint64_t)va_arg(*args, long long int);
+			else if (l_count == 1U)
+				val = (uint64_t)va_arg(*args, long int);
+			else
+				val = (uint64_t)va_arg(*args, int);
+			break;
+		case 'u':
+		case 'x':
+			if (l_count > 1U)
+				val = va_arg(*args, unsigned long long int);
+			else if (l_count == 1U)
+				val = va_arg(*args, unsigned long int);
+			else
+				val = va_arg(*args, unsigned int);
+			break;
+		case 'p':
+			val = (uintptr_t)va_arg(*args, void *);
+			break;
+		case 's':
+			str = va_arg(*args, const char *);
+			len = strnlen(str, TF_LOG_BIN_MAX_STR_LEN);
+			if (rec != NULL) {
+				for (i = 0U; i < len; i++)
+					rec[size + i] = (uint8_t)str[i];
+				rec[size + len] = 0U;
+			}
+			size += len + 1U;
+			continue;
+		default:
+			/* vprintf() stops printing on other specifiers */
+			return size;
+		}
+
+		if (rec != NULL)
+			(void)tf_log_bin_put(rec + size, val, 8U);
+		size += 8U;
+	}
+
+	return size;
+}
+
+/*
+ * Append a record of the log message 'fmt' and its arguments to the binary log,
+ * to be formatted on the host by tools/binary_log/decode_binary_log.py.
+ */
+void tf_log_bin(const char *fmt, va_list args)
+{
+	va_list args_copy;
+	uint32_t size, offset;
+	uint8_t *rec;
+
+	if (!tf_log_bin_started)
+		tf_log_bin_start();
+
+	va_copy(args_copy, args);
+	size = TF_LOG_BIN_RECORD_HDR_SIZE +
+		(uint32_t)tf_log_bin_args(fmt, &args_copy, NULL);
+	va_end(args_copy);
+
+	assert(size <= UINT16_MAX);
+
+	if (!tf_log_bin_reserve(size, &offset))
+		return;
+
+	rec = tf_log_bin_records + offset;
+	rec = tf_log_bin_put(rec, size, 2U);
+	rec = tf_log_bin_put(rec, TF_LOG_BIN_IMAGE, 1U);
+	rec = tf_log_bin_put(rec, 0U, 1U);
+	rec = tf_log_bin_put(rec, (uint32_t)((uintptr_t)fmt -
+				(uintptr_t)&tf_log_bin_image), 4U);
+
+	va_copy(args_copy, args);
+	(void)tf_log_bin_args(fmt, &args_copy, rec);
+	va_end(args_copy);
+}
+
+/*
+ * Write the binary log back to memory, so that the next image or a debugger
+ * can read it with the data cache disabled.
+ */
+void tf_log_bin_flush(void)
+{
+	if (tf_log_bin_started)
+		flush_dcache_range((uintptr_t)tf_log_bin_hdr,
+				   PLAT_TF_LOG_BIN_SIZE);
+}
@@ -32,13 +32,51 @@ static spinlock_t gic_lock;
 #pragma weak gicv3_rdistif_on
 
 
+/*
+ * Number of Distributor registers accessed by the last context save and
+ * restore, for measuring the cost of system suspend.
+ */
+static unsigned int gicd_ctx_save_accesses;
+static unsigned int gicd_ctx_restore_accesses;
+
+/*
+ * With GICV3_SPARSE_CTX_RESTORE, the GIC registers are known to reset to zero
+ * so context words which are zero don't need to be written back on restore.
+ */
+#if GICV3_SPARSE_CTX_RESTORE
+#define SKIP_RESET_VALUE(val)	((val) == 0U)
+#else
+#define SKIP_RESET_VALUE(val)	false
+#endif
+
 /* Helper macros to save and restore GICD registers to and from the context */
 #define RESTORE_GICD_REGS(base, ctx, intr_num, reg, REG)		\
 	do {								\
 		for (unsigned int int_id = MIN_SPI_ID; int_id < (intr_num); \
 				int_id += (1U << REG##_SHIFT)) {	\
+			if (SKIP_RESET_VALUE(ctx->gicd_##reg[		\
+				(int_id - MIN_SPI_ID) >> REG##_SHIFT]))	\
+				continue;				\
 			gicd_write_##reg(base, int_id,			\
 				ctx->gicd_##reg[(int_id - MIN_SPI_ID) >> REG##_SHIFT]); \
+			gicd_ctx_restore_accesses++;			\
+		}							\
+	} while (false)
+
+/*
+ * Writing zero to the set-enable, set-pending and set-active registers has no
+ * effect, so only the non-zero words of these are restored.
+ */
+#define RESTORE_GICD_SET_REGS(base, ctx, intr_num, reg, REG)		\
+	do {								\
+		for (unsigned int int_id = MIN_SPI_ID; int_id < (intr_num); \
+				int_id += (1U << REG##_SHIFT)) {	\
+			if (ctx->gicd_##reg[				\
+				(int_id - MIN_SPI_ID) >> REG##_SHIFT] == 0U) \
+				continue;				\
+			gicd_write_##reg(base, int_id,			\
+				ctx->gicd_##reg[(int_id - MIN_SPI_ID) >> REG##_SHIFT]); \
+			gicd_ctx_restore_accesses++;			\
 		}							\
 	} while (false)
 
@@ -48,6 +86,7 @@ static spinlock_t gic_lock;
 				int_id += (1U << REG##_SHIFT)) {	\
 			ctx->gicd_##reg[(int_id - MIN_SPI_ID) >> REG##_SHIFT] =\
 					gicd_read_##reg(base, int_id);	\
+			gicd_ctx_save_accesses++;			\
 		}							\
 	} while (false)
 
@@ -547,6 +586,7 @@ void gicv3_rdistif_init_restore(unsigned int proc_num,
 {
 	uintptr_t gicr_base;
 	unsigned int int_id;
+	uint32_t prio;
 
 	assert(gicv3_driver_data != NULL);
 	assert(proc_num < gicv3_driver_data->rdistif_num);
@@ -586,30 +626,42 @@ void gicv3_rdistif_init_restore(unsigned int proc_num,
 	gicr_write_propbaser(gicr_base, rdist_ctx->gicr_propbaser);
 	gicr_write_pendbaser(gicr_base, rdist_ctx->gicr_pendbaser);
 
-	gicr_write_igroupr0(gicr_base, rdist_ctx->gicr_igroupr0);
+	if (!SKIP_RESET_VALUE(rdist_ctx->gicr_igroupr0))
+		gicr_write_igroupr0(gicr_base, rdist_ctx->gicr_igroupr0);
 
 	for (int_id = MIN_SGI_ID; int_id < TOTAL_PCPU_INTR_NUM;
 			int_id += (1U << IPRIORITYR_SHIFT)) {
-		gicr_write_ipriorityr(gicr_base, int_id,
-		rdist_ctx->gicr_ipriorityr[
-				(int_id - MIN_SGI_ID) >> IPRIORITYR_SHIFT]);
+		prio = rdist_ctx->gicr_ipriorityr[
+				(int_id - MIN_SGI_ID) >> IPRIORITYR_SHIFT];
+		if (!SKIP_RESET_VALUE(prio))
+			gicr_write_ipriorityr(gicr_base, int_id, prio);
 	}
 
-	gicr_write_icfgr0(gicr_base, rdist_ctx->gicr_icfgr0);
-	gicr_write_icfgr1(gicr_base, rdist_ctx->gicr_icfgr1);
-	gicr_write_igrpmodr0(gicr_base, rdist_ctx->gicr_igrpmodr0);
-	gicr_write_nsacr(gicr_base, rdist_ctx->gicr_nsacr);
+	if (!SKIP_RESET_VALUE(rdist_ctx->gicr_icfgr0))
+		gicr_write_icfgr0(gicr_base, rdist_ctx->gicr_icfgr0);
+	if (!SKIP_RESET_VALUE(rdist_ctx->gicr_icfgr1))
+		gicr_write_icfgr1(gicr_base, rdist_ctx->gicr_icfgr1);
+	if (!SKIP_RESET_VALUE(rdist_ctx->gicr_igrpmodr0))
+		gicr_write_igrpmodr0(gicr_base, rdist_ctx->gicr_igrpmodr0);
+	if (!SKIP_RESET_VALUE(rdist_ctx->gicr_nsacr))
+		gicr_write_nsacr(gicr_base, rdist_ctx->gicr_nsacr);
 
-	/* Restore after group and priorities are set */
-	gicr_write_ispendr0(gicr_base, rdist_ctx->gicr_ispendr0);
-	gicr_write_isactiver0(gicr_base, rdist_ctx->gicr_isactiver0);
+	/*
+	 * Restore after group and priorities are set. Writing zero to these
+	 * has no effect.
+	 */
+	if (rdist_ctx->gicr_ispendr0 != 0U)
+		gicr_write_ispendr0(gicr_base, rdist_ctx->gicr_ispendr0);
+	if (rdist_ctx->gicr_isactiver0 != 0U)
+		gicr_write_isactiver0(gicr_base, rdist_ctx->gicr_isactiver0);
 
 	/*
 	 * Wait for all writes to the Distributor to complete before enabling
 	 * the SGI and PPIs.
 	 */
 	gicr_wait_for_upstream_pending_write(gicr_base);
-	gicr_write_isenabler0(gicr_base, rdist_ctx->gicr_isenabler0);
+	if (rdist_ctx->gicr_isenabler0 != 0U)
+		gicr_write_isenabler0(gicr_base, rdist_ctx->gicr_isenabler0);
 
 	/*
 	 * Restore GICR_CTLR.Enable_LPIs bit and wait for pending writes in case
@@ -649,6 +701,7 @@ void gicv3_distif_save(gicv3_dist_ctx_t * const dist_ctx)
 
 	/* Save the GICD_CTLR */
 	dist_ctx->gicd_ctlr = gicd_read_ctlr(gicd_base);
+	gicd_ctx_save_accesses = 1U;
 
 	/* Save GICD_IGROUPR for INTIDs 32 - 1019 */
 	SAVE_GICD_REGS(gicd_base, dist_ctx, num_ints, igroupr, IGROUPR);
@@ -724,6 +777,8 @@ void gicv3_distif_init_restore(const gicv3_dist_ctx_t * const dist_ctx)
 	if (num_ints > (MAX_SPI_ID + 1U))
 		num_ints = MAX_SPI_ID + 1U;
 
+	gicd_ctx_restore_accesses = 0U;
+
 	/* Restore GICD_IGROUPR for INTIDs 32 - 1019 */
 	RESTORE_GICD_REGS(gicd_base, dist_ctx, num_ints, igroupr, IGROUPR);
 
@@ -748,20 +803,35 @@ void gicv3_distif_init_restore(const gicv3_dist_ctx_t * const dist_ctx)
 	 */
 
 	/* Restore GICD_ISENABLER for INT_IDs 32 - 1019 */
-	RESTORE_GICD_REGS(gicd_base, dist_ctx, num_ints, isenabler, ISENABLER);
+	RESTORE_GICD_SET_REGS(gicd_base, dist_ctx, num_ints, isenabler, ISENABLER);
 
 	/* Restore GICD_ISPENDR for INTIDs 32 - 1019 */
-	RESTORE_GICD_REGS(gicd_base, dist_ctx, num_ints, ispendr, ISPENDR);
+	RESTORE_GICD_SET_REGS(gicd_base, dist_ctx, num_ints, ispendr, ISPENDR);
 
 	/* Restore GICD_ISACTIVER for INTIDs 32 - 1019 */
-	RESTORE_GICD_REGS(gicd_base, dist_ctx, num_ints, isactiver, ISACTIVER);
+	RESTORE_GICD_SET_REGS(gicd_base, dist_ctx, num_ints, isactiver, ISACTIVER);
 
 	/* Restore the GICD_CTLR */
 	gicd_write_ctlr(gicd_base, dist_ctx->gicd_ctlr);
+	gicd_ctx_restore_accesses++;
 	gicd_wait_for_pending_write(gicd_base);
 
 }
 
+/*****************************************************************************
+ * Function to retrieve the number of Distributor registers accessed by the
+ * last call to gicv3_distif_save() and gicv3_distif_init_restore().
+ *****************************************************************************/
+void gicv3_distif_get_ctx_accesses(unsigned int *save_accesses,
+				   unsigned int *restore_accesses)
+{
+	assert(save_accesses != NULL);
+	assert(restore_accesses != NULL);
+
+	*save_accesses = gicd_ctx_save_accesses;
+	*restore_accesses = gicd_ctx_restore_accesses;
+}
+
 /*******************************************************************************
  * This function gets the priority of the interrupt the processor is currently
  * servicing.
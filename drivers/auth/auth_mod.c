@@ -5,6 +5,7 @@
  */
 
 #include <assert.h>
+#include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
 
@@ -34,6 +35,14 @@
 extern const auth_img_desc_t *const *const cot_desc_ptr;
 extern unsigned int auth_img_flags[MAX_NUMBER_IDS];
 
+/*
+ * Image whose hash is being calculated while it is loaded, and number of bytes
+ * hashed so far. See auth_mod_hash_start().
+ */
+static bool hash_in_progress;
+static unsigned int hash_img_id;
+static unsigned int hash_img_len;
+
 static int cmp_auth_param_type_desc(const auth_param_type_desc_t *a,
 		const auth_param_type_desc_t *b)
 {
@@ -89,13 +98,14 @@ static int auth_get_param(const auth_param_type_desc_t *param_type_desc,
  *             and parent image
  *   img: pointer to image in memory
  *   img_len: length of image (in bytes)
+ *   hashed: true if the image was hashed while it was loaded
  *
  * Return:
  *   0 = success, Otherwise = error
  */
 static int auth_hash(const auth_method_param_hash_t *param,
 		     const auth_img_desc_t *img_desc,
-		     void *img, unsigned int img_len)
+		     void *img, unsigned int img_len, bool hashed)
 {
 	void *data_ptr, *hash_der_ptr;
 	unsigned int data_len, hash_der_len;
@@ -112,6 +122,12 @@ static int auth_hash(const auth_method_param_hash_t *param,
 			img, img_len, &data_ptr, &data_len);
 	return_if_error(rc);
 
+	/* If the whole image was hashed while it was loaded, just check the
+	 * result. Otherwise calculate the hash now. */
+	if (hashed && (data_ptr == img) && (data_len == hash_img_len)) {
+		return crypto_mod_hash_final(hash_der_ptr, hash_der_len);
+	}
+
 	/* Ask the crypto module to verify this hash */
 	rc = crypto_mod_verify_hash(data_ptr, data_len,
 				    hash_der_ptr, hash_der_len);
@@ -294,6 +310,42 @@ int plat_set_nv_ctr2(void *cookie, const auth_img_desc_t *img_desc __unused,
 	return plat_set_nv_ctr(cookie, nv_ctr);
 }
 
+/*
+ * Images that have been authenticated are not authenticated again when they
+ * are the parent of another image: the parameters extracted from them are
+ * reused instead. Platforms may however share the buffers used to store the
+ * parameters of different images (see tbbr_cot.c). When such a buffer is
+ * overwritten, any other image that stored a parameter in it must be
+ * authenticated again before its children can be verified.
+ */
+static void auth_invalidate_param_owners(unsigned int img_id, const void *buf)
+{
+	const auth_img_desc_t *img_desc;
+	unsigned int id;
+	int i;
+
+	for (id = 0U; id < MAX_NUMBER_IDS; id++) {
+		/* Only authenticated images are known to be in the CoT */
+		if ((id == img_id) ||
+		    ((auth_img_flags[id] & IMG_FLAG_AUTHENTICATED) == 0U)) {
+			continue;
+		}
+
+		img_desc = cot_desc_ptr[id];
+		if (img_desc->authenticated_data == NULL) {
+			continue;
+		}
+
+		for (i = 0 ; i < COT_MAX_VERIFIED_PARAMS ; i++) {
+			if ((img_desc->authenticated_data[i].type_desc != NULL) &&
+			    (img_desc->authenticated_data[i].data.ptr == buf)) {
+				auth_img_flags[id] &= ~IMG_FLAG_AUTHENTICATED;
+				break;
+			}
+		}
+	}
+}
+
 /*
  * Return the parent id in the output parameter '*parent_id'
  *
@@ -325,6 +377,86 @@ int auth_mod_get_parent_id(unsigned int img_id, unsigned int *parent_id)
 	return 0;
 }
 
+/*
+ * Start calculating the hash of an image before it is loaded
+ *
+ * This is possible when the image is a binary that is authenticated with
+ * 'AUTH_METHOD_HASH' and its parent has already been authenticated. The
+ * loader then passes the image to auth_mod_hash_update() as it is read, and
+ * auth_mod_verify_img() only has to check the result.
+ *
+ * Return value:
+ *   0 = Hash calculation started, Otherwise = the image must be hashed by
+ *   auth_mod_verify_img() once it is fully loaded
+ */
+int auth_mod_hash_start(unsigned int img_id)
+{
+	const auth_img_desc_t *img_desc;
+	const auth_method_desc_t *auth_method;
+	void *hash_der_ptr;
+	unsigned int hash_der_len;
+	int rc, i;
+
+	hash_in_progress = false;
+
+	img_desc = cot_desc_ptr[img_id];
+	if ((img_desc->img_type != IMG_RAW) ||
+	    (img_desc->img_auth_methods == NULL)) {
+		return 1;
+	}
+
+	for (i = 0 ; i < AUTH_METHOD_NUM ; i++) {
+		auth_method = &img_desc->img_auth_methods[i];
+		if (auth_method->type != AUTH_METHOD_HASH) {
+			continue;
+		}
+
+		rc = auth_get_param(auth_method->param.hash.hash,
+				    img_desc->parent,
+				    &hash_der_ptr, &hash_der_len);
+		return_if_error(rc);
+
+		rc = crypto_mod_hash_init(hash_der_ptr, hash_der_len);
+		return_if_error(rc);
+
+		hash_in_progress = true;
+		hash_img_id = img_id;
+		hash_img_len = 0;
+		return 0;
+	}
+
+	return 1;
+}
+
+/*
+ * Add a chunk of the image being loaded to the hash started by
+ * auth_mod_hash_start(). Chunks must be passed in order. On error the hash
+ * calculation is abandoned and the image is hashed in auth_mod_verify_img()
+ * instead.
+ */
+void auth_mod_hash_update(void *ptr, unsigned int len)
+{
+	if (!hash_in_progress) {
+		return;
+	}
+
+	if (crypto_mod_hash_update(ptr, len) != 0) {
+		hash_in_progress = false;
+		return;
+	}
+
+	hash_img_len += len;
+}
+
+/*
+ * Abandon the hash started by auth_mod_hash_start(), e.g. when the image
+ * failed to load, so that it can't be used to authenticate anything else.
+ */
+void auth_mod_hash_abort(void)
+{
+	hash_in_progress = false;
+}
+
 /*
  * Initialize the different modules in the authentication framework
  */
@@ -354,6 +486,14 @@ int auth_mod_verify_img(unsigned int img_id,
 	void *param_ptr;
 	unsigned int param_len;
 	int rc, i;
+	bool hashed;
+
+	/*
+	 * A hash calculated while the image was loaded can only be used by this
+	 * verification, whatever its outcome.
+	 */
+	hashed = hash_in_progress && (hash_img_id == img_id);
+	hash_in_progress = false;
 
 	/* Get the image descriptor from the chain of trust */
 	img_desc = cot_desc_ptr[img_id];
@@ -374,7 +514,7 @@ int auth_mod_verify_img(unsigned int img_id,
 			break;
 		case AUTH_METHOD_HASH:
 			rc = auth_hash(&auth_method->param.hash,
-					img_desc, img_ptr, img_len);
+					img_desc, img_ptr, img_len, hashed);
 			break;
 		case AUTH_METHOD_SIG:
 			rc = auth_signature(&auth_method->param.sig,
@@ -411,6 +551,10 @@ int auth_mod_verify_img(unsigned int img_id,
 				return 1;
 			}
 
+			/* Images sharing this buffer lose their parameter */
+			auth_invalidate_param_owners(img_desc->img_id,
+				img_desc->authenticated_data[i].data.ptr);
+
 			/* Copy the parameter for later use */
 			memcpy((void *)img_desc->authenticated_data[i].data.ptr,
 					(void *)param_ptr, param_len);
@@ -48,6 +48,12 @@ void crypto_mod_init(void)
 	assert(crypto_lib_desc.init != NULL);
 	assert(crypto_lib_desc.verify_signature != NULL);
 	assert(crypto_lib_desc.verify_hash != NULL);
+	assert(((crypto_lib_desc.hash_init == NULL) &&
+		(crypto_lib_desc.hash_update == NULL) &&
+		(crypto_lib_desc.hash_final == NULL)) ||
+	       ((crypto_lib_desc.hash_init != NULL) &&
+		(crypto_lib_desc.hash_update != NULL) &&
+		(crypto_lib_desc.hash_final != NULL)));
 
 	/* Initialize the cryptographic library */
 	crypto_lib_desc.init();
@@ -103,3 +109,60 @@ int crypto_mod_verify_hash(void *data_ptr, unsigned int data_len,
 	return crypto_lib_desc.verify_hash(data_ptr, data_len,
 					   digest_info_ptr, digest_info_len);
 }
+
+/*
+ * Start an incremental hash calculation
+ *
+ * Returns CRYPTO_ERR_NOT_SUPPORTED if the library can't hash incrementally,
+ * in which case the caller must use crypto_mod_verify_hash() instead.
+ *
+ * Parameters:
+ *
+ *   digest_info_ptr, digest_info_len: hash that will be compared in
+ *                                     crypto_mod_hash_final(), which
+ *                                     specifies the hash algorithm
+ */
+int crypto_mod_hash_init(void *digest_info_ptr, unsigned int digest_info_len)
+{
+	assert(digest_info_ptr != NULL);
+	assert(digest_info_len != 0);
+
+	if (crypto_lib_desc.hash_init == NULL) {
+		return CRYPTO_ERR_NOT_SUPPORTED;
+	}
+
+	return crypto_lib_desc.hash_init(digest_info_ptr, digest_info_len);
+}
+
+/*
+ * Add data to the hash calculation started by crypto_mod_hash_init()
+ *
+ * Parameters:
+ *
+ *   data_ptr, data_len: data to be hashed
+ */
+int crypto_mod_hash_update(void *data_ptr, unsigned int data_len)
+{
+	assert(data_ptr != NULL);
+	assert(data_len != 0);
+	assert(crypto_lib_desc.hash_update != NULL);
+
+	return crypto_lib_desc.hash_update(data_ptr, data_len);
+}
+
+/*
+ * Complete the hash calculation started by crypto_mod_hash_init() and verify
+ * it by comparison
+ *
+ * Parameters:
+ *
+ *   digest_info_ptr, digest_info_len: hash to be compared
+ */
+int crypto_mod_hash_final(void *digest_info_ptr, unsigned int digest_info_len)
+{
+	assert(digest_info_ptr != NULL);
+	assert(digest_info_len != 0);
+	assert(crypto_lib_desc.hash_final != NULL);
+
+	return crypto_lib_desc.hash_final(digest_info_ptr, digest_info_len);
+}
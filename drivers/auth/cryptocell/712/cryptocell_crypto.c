@@ -299,7 +299,9 @@ static int verify_hash(void *data_ptr, unsigned int data_len,
 }
 
 /*
- * Register crypto library descriptor
+ * Register crypto library descriptor. The SBROM only provides a one-shot hash
+ * function, so incremental hashing isn't supported.
  */
-REGISTER_CRYPTO_LIB(LIB_NAME, init, verify_signature, verify_hash);
+REGISTER_CRYPTO_LIB(LIB_NAME, init, verify_signature, verify_hash,
+		    NULL, NULL, NULL);
 
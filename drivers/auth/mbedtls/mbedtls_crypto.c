@@ -136,19 +136,18 @@ end2:
 }
 
 /*
- * Match a hash
+ * Parse a DigestInfo and return the hash algorithm and a pointer to the digest.
  *
  * Digest info is passed in DER format following the ASN.1 structure detailed
  * above.
  */
-static int verify_hash(void *data_ptr, unsigned int data_len,
-		       void *digest_info_ptr, unsigned int digest_info_len)
+static int get_digest_info(void *digest_info_ptr, unsigned int digest_info_len,
+			   const mbedtls_md_info_t **md_info,
+			   unsigned char **hash)
 {
 	mbedtls_asn1_buf hash_oid, params;
 	mbedtls_md_type_t md_alg;
-	const mbedtls_md_info_t *md_info;
-	unsigned char *p, *end, *hash;
-	unsigned char data_hash[MBEDTLS_MD_MAX_SIZE];
+	unsigned char *p, *end;
 	size_t len;
 	int rc;
 
@@ -172,8 +171,8 @@ static int verify_hash(void *data_ptr, unsigned int data_len,
 		return CRYPTO_ERR_HASH;
 	}
 
-	md_info = mbedtls_md_info_from_type(md_alg);
-	if (md_info == NULL) {
+	*md_info = mbedtls_md_info_from_type(md_alg);
+	if (*md_info == NULL) {
 		return CRYPTO_ERR_HASH;
 	}
 
@@ -184,10 +183,32 @@ static int verify_hash(void *data_ptr, unsigned int data_len,
 	}
 
 	/* Length of hash must match the algorithm's size */
-	if (len != mbedtls_md_get_size(md_info)) {
+	if (len != mbedtls_md_get_size(*md_info)) {
 		return CRYPTO_ERR_HASH;
 	}
-	hash = p;
+	*hash = p;
+
+	return CRYPTO_SUCCESS;
+}
+
+/*
+ * Match a hash
+ *
+ * Digest info is passed in DER format following the ASN.1 structure detailed
+ * above.
+ */
+static int verify_hash(void *data_ptr, unsigned int data_len,
+		       void *digest_info_ptr, unsigned int digest_info_len)
+{
+	const mbedtls_md_info_t *md_info;
+	unsigned char *p, *hash;
+	unsigned char data_hash[MBEDTLS_MD_MAX_SIZE];
+	int rc;
+
+	rc = get_digest_info(digest_info_ptr, digest_info_len, &md_info, &hash);
+	if (rc != CRYPTO_SUCCESS) {
+		return rc;
+	}
 
 	/* Calculate the hash of the data */
 	p = (unsigned char *)data_ptr;
@@ -205,7 +226,110 @@ static int verify_hash(void *data_ptr, unsigned int data_len,
 	return CRYPTO_SUCCESS;
 }
 
+/* Context and algorithm of the hash calculation in progress, if any */
+static mbedtls_md_context_t hash_ctx;
+static const mbedtls_md_info_t *hash_md_info;
+
+/*
+ * Start an incremental hash calculation using the algorithm given in the
+ * DigestInfo.
+ */
+static int hash_init(void *digest_info_ptr, unsigned int digest_info_len)
+{
+	const mbedtls_md_info_t *md_info;
+	unsigned char *hash;
+	int rc;
+
+	rc = get_digest_info(digest_info_ptr, digest_info_len, &md_info, &hash);
+	if (rc != CRYPTO_SUCCESS) {
+		return rc;
+	}
+
+	/* Release a previous calculation that may not have been completed */
+	mbedtls_md_free(&hash_ctx);
+	mbedtls_md_init(&hash_ctx);
+	hash_md_info = NULL;
+
+	rc = mbedtls_md_setup(&hash_ctx, md_info, 0);
+	if (rc != 0) {
+		return CRYPTO_ERR_HASH;
+	}
+
+	rc = mbedtls_md_starts(&hash_ctx);
+	if (rc != 0) {
+		mbedtls_md_free(&hash_ctx);
+		return CRYPTO_ERR_HASH;
+	}
+
+	hash_md_info = md_info;
+
+	return CRYPTO_SUCCESS;
+}
+
+/*
+ * Add data to the hash calculation in progress
+ */
+static int hash_update(void *data_ptr, unsigned int data_len)
+{
+	int rc;
+
+	if (hash_md_info == NULL) {
+		return CRYPTO_ERR_HASH;
+	}
+
+	rc = mbedtls_md_update(&hash_ctx, (unsigned char *)data_ptr, data_len);
+	if (rc != 0) {
+		return CRYPTO_ERR_HASH;
+	}
+
+	return CRYPTO_SUCCESS;
+}
+
+/*
+ * Complete the hash calculation in progress and match it with the digest in
+ * the DigestInfo
+ */
+static int hash_final(void *digest_info_ptr, unsigned int digest_info_len)
+{
+	const mbedtls_md_info_t *md_info;
+	unsigned char *hash;
+	unsigned char data_hash[MBEDTLS_MD_MAX_SIZE];
+	int rc;
+
+	rc = get_digest_info(digest_info_ptr, digest_info_len, &md_info, &hash);
+	if (rc != CRYPTO_SUCCESS) {
+		goto exit;
+	}
+
+	/* The algorithm must be the one the calculation was started with */
+	if ((hash_md_info == NULL) || (md_info != hash_md_info)) {
+		rc = CRYPTO_ERR_HASH;
+		goto exit;
+	}
+
+	rc = mbedtls_md_finish(&hash_ctx, data_hash);
+	if (rc != 0) {
+		rc = CRYPTO_ERR_HASH;
+		goto exit;
+	}
+
+	/* Compare values */
+	rc = memcmp(data_hash, hash, mbedtls_md_get_size(md_info));
+	if (rc != 0) {
+		rc = CRYPTO_ERR_HASH;
+		goto exit;
+	}
+
+	rc = CRYPTO_SUCCESS;
+
+exit:
+	mbedtls_md_free(&hash_ctx);
+	hash_md_info = NULL;
+	return rc;
+}
+
 /*
  * Register crypto library descriptor
  */
-REGISTER_CRYPTO_LIB(LIB_NAME, init, verify_signature, verify_hash);
+REGISTER_CRYPTO_LIB(LIB_NAME, init, verify_signature, verify_hash,
+		    hash_init, hash_update, hash_final);
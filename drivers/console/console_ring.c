@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2020, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <assert.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <arch_helpers.h>
+#include <drivers/console_ring.h>
+#include <lib/cassert.h>
+#include <plat/common/platform.h>
+
+CASSERT(IS_POWER_OF_TWO(PLAT_CONSOLE_RING_SIZE),
+	assert_console_ring_size_power_of_two);
+
+/*
+ * The rings live in a platform provided region when the platform wants to
+ * expose them to the Non-secure world, or in BL31 memory otherwise.
+ */
+#ifdef PLAT_CONSOLE_RING_BASE
+#define console_ring_base	((uint8_t *)PLAT_CONSOLE_RING_BASE)
+#else
+static uint8_t console_ring_buf[CONSOLE_RING_REGION_SIZE]
+	__aligned(CACHE_WRITEBACK_GRANULE);
+#define console_ring_base	(console_ring_buf)
+#endif
+
+#define console_ring_hdr	((console_ring_hdr_t *)console_ring_base)
+#define console_ring_data(cpu)						\
+	(console_ring_base + CONSOLE_RING_DATA_OFFSET +			\
+	 ((cpu) * PLAT_CONSOLE_RING_SIZE))
+
+/*
+ * Indexes of each ring. They are kept in BL31 memory, as the region above may
+ * be written by the Non-secure world. 'head' is only written by the CPU owning
+ * the ring and 'tail' is only accessed with the drain lock held.
+ */
+typedef struct console_ring_cpu {
+	uint64_t head;
+	uint64_t tail;
+} __aligned(CACHE_WRITEBACK_GRANULE) console_ring_cpu_t;
+
+static console_ring_cpu_t console_ring_cpus[PLATFORM_CORE_COUNT];
+static unsigned int console_ring_drain_lock;
+static int (*console_ring_output)(int c);
+
+void console_ring_init(int (*output)(int c))
+{
+	console_ring_hdr_t *hdr = console_ring_hdr;
+	unsigned int i;
+
+	assert(output != NULL);
+
+	if (console_ring_output != NULL)
+		return;
+
+	hdr->version = CONSOLE_RING_VERSION;
+	hdr->num_rings = PLATFORM_CORE_COUNT;
+	hdr->ring_size = PLAT_CONSOLE_RING_SIZE;
+	hdr->data_offset = CONSOLE_RING_DATA_OFFSET;
+	hdr->reserved = 0U;
+	for (i = 0U; i < PLATFORM_CORE_COUNT; i++)
+		hdr->head[i] = console_ring_cpus[i].head;
+
+	/* Only advertise the rings once the header is valid */
+	__atomic_store_n(&hdr->magic, CONSOLE_RING_MAGIC, __ATOMIC_RELEASE);
+
+	console_ring_output = output;
+}
+
+/*
+ * The drain lock can't be taken with the data cache disabled (e.g. late in the
+ * CPU power down sequence), and the rings would then be accessed without seeing
+ * the characters still held in the caches, so bypass the rings in that case.
+ */
+static bool console_ring_usable(void)
+{
+	return (console_ring_output != NULL) &&
+	       ((read_sctlr_el3() & SCTLR_C_BIT) != 0U);
+}
+
+int console_ring_putc(int c)
+{
+	console_ring_cpu_t *cpu;
+	unsigned int pos;
+	uint64_t head;
+
+	if (!console_ring_usable())
+		return -1;
+
+	pos = plat_my_core_pos();
+	cpu = &console_ring_cpus[pos];
+	head = cpu->head;
+
+	console_ring_data(pos)[head & (PLAT_CONSOLE_RING_SIZE - 1U)] =
+		(uint8_t)c;
+
+	__atomic_store_n(&cpu->head, head + 1U, __ATOMIC_RELEASE);
+	__atomic_store_n(&console_ring_hdr->head[pos], head + 1U,
+			 __ATOMIC_RELEASE);
+
+	return 0;
+}
+
+/*
+ * Write at most 'budget' characters from the ring of CPU 'pos' to the consoles
+ * and return the remaining budget. Characters overwritten by their producer
+ * before being drained are lost.
+ */
+static unsigned int console_ring_drain_cpu(unsigned int pos,
+					   unsigned int budget)
+{
+	console_ring_cpu_t *cpu = &console_ring_cpus[pos];
+	const uint8_t *data = console_ring_data(pos);
+	uint64_t head = __atomic_load_n(&cpu->head, __ATOMIC_ACQUIRE);
+	uint64_t tail = cpu->tail;
+
+	if ((head - tail) > PLAT_CONSOLE_RING_SIZE)
+		tail = head - PLAT_CONSOLE_RING_SIZE;
+
+	while ((tail != head) && (budget > 0U)) {
+		(void)console_ring_output(
+			data[tail & (PLAT_CONSOLE_RING_SIZE - 1U)]);
+		tail++;
+		budget--;
+	}
+
+	cpu->tail = tail;
+
+	return budget;
+}
+
+/*
+ * Write the whole ring of the calling CPU to the consoles, so that none of its
+ * lines is left behind, then at most 'budget' characters from the rings of the
+ * other CPUs, ring by ring starting with the next CPU so that a busy CPU can't
+ * starve the others. Must be called with the drain lock held, except at panic
+ * time.
+ */
+static void console_ring_drain_locked(unsigned int budget)
+{
+	unsigned int n, i = plat_my_core_pos();
+
+	(void)console_ring_drain_cpu(i, UINT_MAX);
+
+	for (n = 1U; (n < PLATFORM_CORE_COUNT) && (budget > 0U); n++) {
+		i = (i + 1U) % PLATFORM_CORE_COUNT;
+		budget = console_ring_drain_cpu(i, budget);
+	}
+}
+
+static bool console_ring_trylock(void)
+{
+	unsigned int unlocked = 0U;
+
+	return __atomic_compare_exchange_n(&console_ring_drain_lock, &unlocked,
+					   1U, false, __ATOMIC_ACQUIRE,
+					   __ATOMIC_RELAXED);
+}
+
+/*
+ * Only wait for the CPU draining the rings, if any, which is bounded by the
+ * size of its ring and the budget of its drain.
+ */
+static void console_ring_lock(void)
+{
+	while (!console_ring_trylock())
+		;
+}
+
+static void console_ring_unlock(void)
+{
+	__atomic_store_n(&console_ring_drain_lock, 0U, __ATOMIC_RELEASE);
+}
+
+void console_ring_drain(unsigned int budget)
+{
+	if (!console_ring_usable())
+		return;
+
+	console_ring_lock();
+	console_ring_drain_locked(budget);
+	console_ring_unlock();
+}
+
+void console_ring_flush(void)
+{
+	if (!console_ring_usable())
+		return;
+
+	console_ring_lock();
+	console_ring_drain_locked(UINT_MAX);
+	console_ring_unlock();
+}
+
+void console_ring_panic_drain(void)
+{
+	if (!console_ring_usable())
+		return;
+
+	/*
+	 * The owner of the drain lock may be the panicking CPU itself or a CPU
+	 * which will never release it, so drain without it. At worst, some
+	 * characters being drained by another CPU are written twice.
+	 */
+	console_ring_drain_locked(UINT_MAX);
+}
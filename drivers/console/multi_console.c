@@ -8,6 +8,14 @@
 
 #include <drivers/console.h>
 
+/* Runtime console output is only buffered in per-CPU rings in BL31. */
+#if ENABLE_CONSOLE_RING && defined(IMAGE_BL31)
+#define CONSOLE_RING_USED	1
+#include <drivers/console_ring.h>
+#else
+#define CONSOLE_RING_USED	0
+#endif
+
 console_t *console_list;
 uint8_t console_state = CONSOLE_FLAG_BOOT;
 
@@ -58,8 +66,21 @@ int console_is_registered(console_t *to_find)
 	return 0;
 }
 
+#if CONSOLE_RING_USED
+static int console_putc_unbuffered(int c);
+#endif
+
 void console_switch_state(unsigned int new_state)
 {
+#if CONSOLE_RING_USED
+	/* Write out the runtime output before the runtime consoles go quiet */
+	if ((console_state == CONSOLE_FLAG_RUNTIME) &&
+	    (new_state != CONSOLE_FLAG_RUNTIME))
+		console_ring_flush();
+	else if (new_state == CONSOLE_FLAG_RUNTIME)
+		console_ring_init(console_putc_unbuffered);
+#endif
+
 	console_state = new_state;
 }
 
@@ -84,7 +105,7 @@ static int do_putc(int c, console_t *console)
 	return console->putc(c, console);
 }
 
-int console_putc(int c)
+static int console_putc_unbuffered(int c)
 {
 	int err = ERROR_NO_VALID_CONSOLE;
 	console_t *console;
@@ -99,6 +120,20 @@ int console_putc(int c)
 	return err;
 }
 
+int console_putc(int c)
+{
+#if CONSOLE_RING_USED
+	if ((console_state == CONSOLE_FLAG_RUNTIME) &&
+	    (console_ring_putc(c) == 0)) {
+		if (c == '\n')
+			console_ring_drain(PLAT_CONSOLE_RING_DRAIN_BUDGET);
+		return c;
+	}
+#endif
+
+	return console_putc_unbuffered(c);
+}
+
 int console_getc(void)
 {
 	int err = ERROR_NO_VALID_CONSOLE;
@@ -124,6 +159,11 @@ int console_flush(void)
 	int err = ERROR_NO_VALID_CONSOLE;
 	console_t *console;
 
+#if CONSOLE_RING_USED
+	if (console_state == CONSOLE_FLAG_RUNTIME)
+		console_ring_flush();
+#endif
+
 	for (console = console_list; console != NULL; console = console->next)
 		if ((console->flags & console_state) && console->flush) {
 			int ret = console->flush(console);
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2017, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2016-2020, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -25,6 +25,39 @@ typedef struct {
 
 #define is_power_of_2(x)	((x != 0) && ((x & (x - 1)) == 0))
 
+/*
+ * Return the number of bytes that can be transferred directly between the
+ * low level driver and the caller's buffer, bypassing the device buffer, or 0
+ * if the bounce buffer must be used. This is only possible if the driver
+ * accepts any buffer, for whole blocks starting at a block boundary, and only
+ * if the caller's buffer satisfies the same alignment constraint as the device
+ * buffer. Requests are limited to the size of the device buffer, which is what
+ * low level drivers are sized for.
+ */
+static size_t block_direct_length(const io_block_dev_spec_t *dev_spec,
+				  size_t file_pos, uintptr_t user_buf,
+				  size_t left)
+{
+	size_t block_size = dev_spec->block_size;
+	size_t request;
+
+	if (!dev_spec->direct) {
+		return 0;
+	}
+
+	if (((file_pos & (block_size - 1)) != 0) ||
+	    ((user_buf & (block_size - 1)) != 0)) {
+		return 0;
+	}
+
+	request = left & ~(block_size - 1);
+	if (request > dev_spec->buffer.length) {
+		request = dev_spec->buffer.length;
+	}
+
+	return request;
+}
+
 io_type_t device_type_block(void);
 
 static int block_open(io_dev_info_t *dev_info, const uintptr_t spec,
@@ -240,6 +273,11 @@ static int block_seek(io_entity_t *entity, int mode, ssize_t offset)
  *
  * Additionally, the IO driver has an underlying buffer that is at least
  * one block-size and may be big enough to allow.
+ *
+ * When file_pos is block aligned and the caller's buffer has the same
+ * alignment as the device buffer, whole blocks are read directly into the
+ * caller's buffer, avoiding the copy out of the device buffer. For a large
+ * request this means only the head and tail blocks are bounced.
  */
 static int block_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 		      size_t *length_read)
@@ -296,7 +334,37 @@ static int block_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 		 */
 		lba = (cur->file_pos + cur->base) / block_size;
 
-		if (skip + left > buf->length) {
+		/*
+		 * Whole aligned blocks are read straight into the user
+		 * buffer. Only the unaligned head and tail go through the
+		 * device buffer.
+		 */
+		request = block_direct_length(cur->dev_spec, cur->file_pos,
+					      buffer + count, left);
+		if (request != 0) {
+			request = ops->read(lba, buffer + count, request);
+			/* Only account for the whole blocks that were read */
+			nbytes = request & ~(block_size - 1);
+			if (nbytes == 0) {
+				return -EIO;
+			}
+
+			cur->file_pos += nbytes;
+			count += nbytes;
+			continue;
+		}
+
+		if ((skip != 0) && (left > (block_size - skip)) &&
+		    (block_direct_length(cur->dev_spec,
+					 cur->file_pos + block_size - skip,
+					 buffer + count + block_size - skip,
+					 left - (block_size - skip)) != 0)) {
+			/*
+			 * Only the unaligned head block needs the device
+			 * buffer, the rest can be transferred directly.
+			 */
+			request = block_size;
+		} else if (skip + left > buf->length) {
 			/*
 			 * The underlying read buffer is too small to
 			 * read all the required data - limit to just
@@ -408,7 +476,35 @@ static int block_write(io_entity_t *entity, const uintptr_t buffer,
 		 */
 		lba = (cur->file_pos + cur->base) / block_size;
 
-		if (skip + left > buf->length) {
+		/*
+		 * Whole aligned blocks are written straight from the user
+		 * buffer, there is no content to preserve around them.
+		 */
+		request = block_direct_length(cur->dev_spec, cur->file_pos,
+					      buffer + count, left);
+		if (request != 0) {
+			request = ops->write(lba, buffer + count, request);
+			nbytes = request & ~(block_size - 1);
+			if (nbytes == 0) {
+				return -EIO;
+			}
+
+			cur->file_pos += nbytes;
+			count += nbytes;
+			continue;
+		}
+
+		if ((skip != 0) && (left > (block_size - skip)) &&
+		    (block_direct_length(cur->dev_spec,
+					 cur->file_pos + block_size - skip,
+					 buffer + count + block_size - skip,
+					 left - (block_size - skip)) != 0)) {
+			/*
+			 * Only the unaligned head block needs the device
+			 * buffer, the rest can be transferred directly.
+			 */
+			request = block_size;
+		} else if (skip + left > buf->length) {
 			/*
 			 * The underlying read buffer is too small to
 			 * read all the required data - limit to just
@@ -6,6 +6,7 @@
 
 #include <assert.h>
 #include <errno.h>
+#include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
 
@@ -33,32 +34,47 @@
 		x.node[0], x.node[1], x.node[2], x.node[3],			\
 		x.node[4], x.node[5]
 
-typedef struct {
-	unsigned int file_pos;
-	fip_toc_entry_t entry;
-} file_state_t;
+/*
+ * Maximum number of ToC entries cached per FIP device. The ToC is parsed once
+ * when the device is initialised, so the platform must make sure this is large
+ * enough to hold every image present in its FIP.
+ */
+#ifndef MAX_FIP_TOC_ENTRIES
+#define MAX_FIP_TOC_ENTRIES	32
+#endif
+
+/* Maximum number of files that can be open at once across all FIP devices */
+#ifndef MAX_FIP_FILES
+#define MAX_FIP_FILES		MAX_IO_HANDLES
+#endif
 
 /*
- * Maintain dev_spec per FIP Device
- * TODO - Add backend handles and file state
- * per FIP device here once backends like io_memmap
- * can support multiple open files
+ * Maintain dev_spec, backend reference and a cached copy of the Table of
+ * Contents per FIP Device. The ToC is read from the backend once, in
+ * fip_dev_init(), and is valid until the device is closed.
  */
 typedef struct {
 	uintptr_t dev_spec;
+	uintptr_t backend_dev_handle;
+	uintptr_t backend_image_spec;
+	bool toc_valid;
+	unsigned int toc_count;
+	fip_toc_entry_t toc[MAX_FIP_TOC_ENTRIES];
 } fip_dev_state_t;
 
-static const uuid_t uuid_null;
 /*
- * Only one file can be open across all FIP device
- * as backends like io_memmap don't support
- * multiple open files. The file state and
- * backend handle should be maintained per FIP device
- * if the same support is available in the backend
+ * The backend is only opened for the duration of a single read, so several
+ * files can be open at once as long as each keeps its own cursor. A slot is
+ * free when its entry pointer is NULL.
  */
-static file_state_t current_file = {0};
-static uintptr_t backend_dev_handle;
-static uintptr_t backend_image_spec;
+typedef struct {
+	unsigned int file_pos;
+	const fip_toc_entry_t *entry;
+	const fip_dev_state_t *dev_state;
+} file_state_t;
+
+static const uuid_t uuid_null;
+static file_state_t file_pool[MAX_FIP_FILES];
 
 static fip_dev_state_t state_pool[MAX_FIP_DEVICES];
 static io_dev_info_t dev_info_pool[MAX_FIP_DEVICES];
@@ -183,8 +199,7 @@ static int free_dev_info(io_dev_info_t *dev_info)
 
 /*
  * Multiple FIP devices can be opened depending on the value of
- * MAX_FIP_DEVICES. Given that there is only one backend, only a
- * single file can be open at a time by any FIP device.
+ * MAX_FIP_DEVICES. Each device keeps its own backend reference and ToC cache.
  */
 static int fip_dev_open(const uintptr_t dev_spec,
 			 io_dev_info_t **dev_info)
@@ -212,14 +227,59 @@ static int fip_dev_open(const uintptr_t dev_spec,
 }
 
 
-/* Do some basic package checks. */
+/* Read the Table of Contents from the backend into the device state. */
+static int fip_read_toc(fip_dev_state_t *state, uintptr_t backend_handle)
+{
+	int result;
+	size_t bytes_read;
+	fip_toc_entry_t entry;
+
+	state->toc_count = 0U;
+
+	for (;;) {
+		result = io_read(backend_handle, (uintptr_t)&entry,
+				 sizeof(entry), &bytes_read);
+		if ((result != 0) || (bytes_read != sizeof(entry))) {
+			WARN("Failed to read FIP (%i)\n", result);
+			return -ENOENT;
+		}
+
+		/* The ToC is terminated by an entry with a null UUID */
+		if (compare_uuids(&entry.uuid, &uuid_null) == 0) {
+			break;
+		}
+
+		if (state->toc_count == (unsigned int)MAX_FIP_TOC_ENTRIES) {
+			WARN("FIP ToC has more than %u entries\n",
+			     (unsigned int)MAX_FIP_TOC_ENTRIES);
+			return -ENOMEM;
+		}
+
+		state->toc[state->toc_count] = entry;
+		state->toc_count++;
+	}
+
+	VERBOSE("FIP ToC cached (%u entries)\n", state->toc_count);
+
+	return 0;
+}
+
+
+/* Do some basic package checks and cache the Table of Contents. */
 static int fip_dev_init(io_dev_info_t *dev_info, const uintptr_t init_params)
 {
 	int result;
 	unsigned int image_id = (unsigned int)init_params;
 	uintptr_t backend_handle;
+	uintptr_t backend_dev_handle;
+	uintptr_t backend_image_spec;
 	fip_toc_header_t header;
 	size_t bytes_read;
+	fip_dev_state_t *state;
+
+	assert(dev_info != NULL);
+
+	state = (fip_dev_state_t *)dev_info->info;
 
 	/* Obtain a reference to the image by querying the platform layer */
 	result = plat_get_image_source(image_id, &backend_dev_handle,
@@ -231,6 +291,17 @@ static int fip_dev_init(io_dev_info_t *dev_info, const uintptr_t init_params)
 		goto fip_dev_init_exit;
 	}
 
+	/* Nothing to do if the ToC of this package has already been cached */
+	if (state->toc_valid &&
+	    (state->backend_dev_handle == backend_dev_handle) &&
+	    (state->backend_image_spec == backend_image_spec)) {
+		return 0;
+	}
+
+	state->toc_valid = false;
+	state->backend_dev_handle = backend_dev_handle;
+	state->backend_image_spec = backend_image_spec;
+
 	/* Attempt to access the FIP image */
 	result = io_open(backend_dev_handle, backend_image_spec,
 			 &backend_handle);
@@ -248,9 +319,15 @@ static int fip_dev_init(io_dev_info_t *dev_info, const uintptr_t init_params)
 			result = -ENOENT;
 		} else {
 			VERBOSE("FIP header looks OK.\n");
+			/* The ToC immediately follows the header */
+			result = fip_read_toc(state, backend_handle);
 		}
 	}
 
+	if (result == 0) {
+		state->toc_valid = true;
+	}
+
 	io_close(backend_handle);
 
  fip_dev_init_exit:
@@ -260,93 +337,92 @@ static int fip_dev_init(io_dev_info_t *dev_info, const uintptr_t init_params)
 /* Close a connection to the FIP device */
 static int fip_dev_close(io_dev_info_t *dev_info)
 {
-	/* TODO: Consider tracking open files and cleaning them up here */
+	fip_dev_state_t *state;
+	unsigned int i;
 
-	/* Clear the backend. */
-	backend_dev_handle = (uintptr_t)NULL;
-	backend_image_spec = (uintptr_t)NULL;
+	assert(dev_info != NULL);
+
+	state = (fip_dev_state_t *)dev_info->info;
+
+	/* Files still open on this device cannot be used any more */
+	for (i = 0U; i < (unsigned int)MAX_FIP_FILES; i++) {
+		if (file_pool[i].dev_state == state) {
+			zeromem(&file_pool[i], sizeof(file_pool[i]));
+		}
+	}
+
+	/* Clear the backend and the cached ToC. */
+	state->backend_dev_handle = (uintptr_t)NULL;
+	state->backend_image_spec = (uintptr_t)NULL;
+	state->toc_valid = false;
+	state->toc_count = 0U;
 
 	return free_dev_info(dev_info);
 }
 
 
+/* Look up a file in the cached Table of Contents. */
+static const fip_toc_entry_t *fip_find_toc_entry(const fip_dev_state_t *state,
+						 const uuid_t *uuid)
+{
+	unsigned int i;
+
+	for (i = 0U; i < state->toc_count; i++) {
+		if (compare_uuids(&state->toc[i].uuid, uuid) == 0) {
+			return &state->toc[i];
+		}
+	}
+
+	return NULL;
+}
+
+
 /* Open a file for access from package. */
 static int fip_file_open(io_dev_info_t *dev_info, const uintptr_t spec,
 			 io_entity_t *entity)
 {
-	int result;
-	uintptr_t backend_handle;
 	const io_uuid_spec_t *uuid_spec = (io_uuid_spec_t *)spec;
-	size_t bytes_read;
-	int found_file = 0;
+	const fip_dev_state_t *state;
+	const fip_toc_entry_t *entry;
+	file_state_t *fp = NULL;
+	unsigned int i;
 
+	assert(dev_info != NULL);
 	assert(uuid_spec != NULL);
 	assert(entity != NULL);
 
-	/* Can only have one file open at a time for the moment. We need to
-	 * track state like file cursor position. We know the header lives at
-	 * offset zero, so this entry should never be zero for an active file.
-	 * When the system supports dynamic memory allocation we can allow more
-	 * than one open file at a time if needed.
-	 */
-	if (current_file.entry.offset_address != 0) {
-		WARN("fip_file_open : Only one open file at a time.\n");
-		return -ENOMEM;
-	}
+	state = (fip_dev_state_t *)dev_info->info;
 
-	/* Attempt to access the FIP image */
-	result = io_open(backend_dev_handle, backend_image_spec,
-			 &backend_handle);
-	if (result != 0) {
-		WARN("Failed to open Firmware Image Package (%i)\n", result);
-		result = -ENOENT;
-		goto fip_file_open_exit;
+	if (!state->toc_valid) {
+		WARN("fip_file_open: FIP device not initialised\n");
+		return -ENOENT;
 	}
 
-	/* Seek past the FIP header into the Table of Contents */
-	result = io_seek(backend_handle, IO_SEEK_SET, sizeof(fip_toc_header_t));
-	if (result != 0) {
-		WARN("fip_file_open: failed to seek\n");
-		result = -ENOENT;
-		goto fip_file_open_close;
+	entry = fip_find_toc_entry(state, &uuid_spec->uuid);
+	if (entry == NULL) {
+		/* Did not find the file in the FIP. */
+		return -ENOENT;
 	}
 
-	found_file = 0;
-	do {
-		result = io_read(backend_handle,
-				 (uintptr_t)&current_file.entry,
-				 sizeof(current_file.entry),
-				 &bytes_read);
-		if (result == 0) {
-			if (compare_uuids(&current_file.entry.uuid,
-					  &uuid_spec->uuid) == 0) {
-				found_file = 1;
-				break;
-			}
-		} else {
-			WARN("Failed to read FIP (%i)\n", result);
-			goto fip_file_open_close;
+	/* Allocate a file state to track the file cursor position */
+	for (i = 0U; i < (unsigned int)MAX_FIP_FILES; i++) {
+		if (file_pool[i].entry == NULL) {
+			fp = &file_pool[i];
+			break;
 		}
-	} while (compare_uuids(&current_file.entry.uuid, &uuid_null) != 0);
-
-	if (found_file == 1) {
-		/* All fine. Update entity info with file state and return. Set
-		 * the file position to 0. The 'current_file.entry' holds the
-		 * base and size of the file.
-		 */
-		current_file.file_pos = 0;
-		entity->info = (uintptr_t)&current_file;
-	} else {
-		/* Did not find the file in the FIP. */
-		current_file.entry.offset_address = 0;
-		result = -ENOENT;
 	}
 
- fip_file_open_close:
-	io_close(backend_handle);
+	if (fp == NULL) {
+		WARN("fip_file_open: Too many open files.\n");
+		return -ENOMEM;
+	}
 
- fip_file_open_exit:
-	return result;
+	fp->file_pos = 0U;
+	fp->entry = entry;
+	fp->dev_state = state;
+	entity->info = (uintptr_t)fp;
+
+	return 0;
 }
 
 
@@ -356,7 +432,7 @@ static int fip_file_len(io_entity_t *entity, size_t *length)
 	assert(entity != NULL);
 	assert(length != NULL);
 
-	*length =  ((file_state_t *)entity->info)->entry.size;
+	*length =  ((file_state_t *)entity->info)->entry->size;
 
 	return 0;
 }
@@ -376,19 +452,19 @@ static int fip_file_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 	assert(length_read != NULL);
 	assert(entity->info != (uintptr_t)NULL);
 
+	fp = (file_state_t *)entity->info;
+
 	/* Open the backend, attempt to access the blob image */
-	result = io_open(backend_dev_handle, backend_image_spec,
-			 &backend_handle);
+	result = io_open(fp->dev_state->backend_dev_handle,
+			 fp->dev_state->backend_image_spec, &backend_handle);
 	if (result != 0) {
 		WARN("Failed to open FIP (%i)\n", result);
 		result = -ENOENT;
 		goto fip_file_read_exit;
 	}
 
-	fp = (file_state_t *)entity->info;
-
 	/* Seek to the position in the FIP where the payload lives */
-	file_offset = fp->entry.offset_address + fp->file_pos;
+	file_offset = fp->entry->offset_address + fp->file_pos;
 	result = io_seek(backend_handle, IO_SEEK_SET, file_offset);
 	if (result != 0) {
 		WARN("fip_file_read: failed to seek\n");
@@ -420,11 +496,11 @@ static int fip_file_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 /* Close a file in package */
 static int fip_file_close(io_entity_t *entity)
 {
-	/* Clear our current file pointer.
-	 * If we had malloc() we would free() here.
-	 */
-	if (current_file.entry.offset_address != 0) {
-		zeromem(&current_file, sizeof(current_file));
+	assert(entity != NULL);
+
+	/* Release the file state back to the pool. */
+	if (entity->info != (uintptr_t)NULL) {
+		zeromem((void *)entity->info, sizeof(file_state_t));
 	}
 
 	/* Clear the Entity info. */
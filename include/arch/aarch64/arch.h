@@ -159,6 +159,11 @@
 #define ID_AA64DFR0_PMS_SHIFT	U(32)
 #define ID_AA64DFR0_PMS_MASK	ULL(0xf)
 
+/* ID_AA64ISAR0_EL1 definitions */
+#define ID_AA64ISAR0_TLB_SHIFT	U(56)
+#define ID_AA64ISAR0_TLB_MASK	ULL(0xf)
+#define ID_AA64ISAR0_TLB_RANGE	ULL(0x2)
+
 /* ID_AA64ISAR1_EL1 definitions */
 #define ID_AA64ISAR1_EL1	S3_0_C0_C6_1
 #define ID_AA64ISAR1_GPI_SHIFT	U(28)
@@ -649,6 +654,30 @@
 #define TLBI_ADDR_MASK		ULL(0x00000FFFFFFFFFFF)
 #define TLBI_ADDR(x)		(((x) >> TLBI_ADDR_SHIFT) & TLBI_ADDR_MASK)
 
+/*
+ * Register operand of the TLB range maintenance instructions of ARMv8.4-TLBI.
+ * They invalidate (NUM + 1) * 2^(5 * SCALE + 1) pages starting from BaseADDR.
+ */
+#define TLBI_RANGE_BADDR_MASK	ULL(0x1FFFFFFFFF)
+#define TLBI_RANGE_NUM_SHIFT	U(39)
+#define TLBI_RANGE_NUM_MASK	ULL(0x1f)
+#define TLBI_RANGE_SCALE_SHIFT	U(44)
+#define TLBI_RANGE_SCALE_MASK	ULL(0x3)
+#define TLBI_RANGE_TG_SHIFT	U(46)
+#define TLBI_RANGE_TG_4KB	ULL(0x1)
+
+#define TLBI_RANGE_PAGES(num, scale)	\
+	(((unsigned long long)(num) + 1ULL) << ((5U * (scale)) + 1U))
+#define TLBI_RANGE_MAX_PAGES	TLBI_RANGE_PAGES(TLBI_RANGE_NUM_MASK, \
+						 TLBI_RANGE_SCALE_MASK)
+#define TLBI_RANGE_ADDR(va, num, scale)					\
+	((TLBI_RANGE_TG_4KB << TLBI_RANGE_TG_SHIFT) |			\
+	 (((unsigned long long)(scale) & TLBI_RANGE_SCALE_MASK) <<	\
+	  TLBI_RANGE_SCALE_SHIFT) |					\
+	 (((unsigned long long)(num) & TLBI_RANGE_NUM_MASK) <<		\
+	  TLBI_RANGE_NUM_SHIFT) |					\
+	 (TLBI_ADDR(va) & TLBI_RANGE_BADDR_MASK))
+
 /*******************************************************************************
  * Definitions of register offsets and fields in the CNTCTLBase Frame of the
  * system level implementation of the Generic Timer.
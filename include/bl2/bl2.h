@@ -7,6 +7,7 @@
 #ifndef BL2_H
 #define BL2_H
 
+#include <cdefs.h>
 #include <stdint.h>
 
 void bl2_setup(u_register_t arg0, u_register_t arg1, u_register_t arg2,
@@ -15,4 +16,21 @@ void bl2_el3_setup(u_register_t arg0, u_register_t arg1, u_register_t arg2,
 		   u_register_t arg3);
 void bl2_main(void);
 
+#if BL2_PARALLEL_HASH
+/*
+ * Hashing of the images on a secondary CPU while they are loaded, see
+ * BL2_PARALLEL_HASH. bl2_par_hash_update() queues a chunk of the image whose
+ * hash has been started by auth_mod_hash_start(), and bl2_par_hash_wait()
+ * waits for all the queued chunks to be hashed.
+ */
+void bl2_par_hash_init(void);
+void bl2_par_hash_update(void *ptr, unsigned int len);
+void bl2_par_hash_wait(void);
+void bl2_par_hash_exit(void);
+
+void bl2_par_hash_entrypoint(void);
+void bl2_par_hash_worker(void) __dead2;
+void bl2_par_hash_park(void) __dead2;
+#endif
+
 #endif /* BL2_H */
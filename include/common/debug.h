@@ -97,10 +97,19 @@ void backtrace(const char *cookie);
 
 void __dead2 do_panic(void);
 
+#if ENABLE_BINARY_LOG
+void tf_log_bin_flush(void);
+#else
+static inline void tf_log_bin_flush(void)
+{
+}
+#endif
+
 #define panic()				\
 	do {				\
 		backtrace(__func__);	\
 		(void)console_flush();	\
+		tf_log_bin_flush();	\
 		do_panic();		\
 	} while (false)
 
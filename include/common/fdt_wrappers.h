@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2018-2020, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -12,6 +12,12 @@
 /* Number of cells, given total length in bytes. Each cell is 4 bytes long */
 #define NCELLS(len) ((len) / 4U)
 
+int fdtw_index_init(const void *dtb, void *arena, size_t size);
+void fdtw_index_clear(void);
+int fdtw_node_offset_by_compatible(const void *dtb, int startoffset,
+		const char *compatible);
+int fdtw_path_offset(const void *dtb, const char *path);
+
 int fdtw_read_cells(const void *dtb, int node, const char *prop,
 		unsigned int cells, void *value);
 int fdtw_read_array(const void *dtb, int node, const char *prop,
@@ -31,6 +31,14 @@
 #endif /* __aarch64__ */
 #define SIZEOF_RT_SVC_DESC	(U(1) << RT_SVC_SIZE_LOG2)
 
+/*
+ * Constants to allow the assembler access the table of fast path handlers.
+ * The number of slots must be a power of 2.
+ */
+#define RT_SVC_FAST_FN_SIZE_LOG2	U(4)
+#define RT_SVC_FAST_FN_HANDLE		U(8)
+#define RT_SVC_FAST_FN_SLOTS		U(32)
+
 
 /*
  * In SMCCC 1.X, the function identifier has 6 bits for the owning entity number
@@ -81,6 +89,36 @@ typedef struct rt_svc_desc {
 			.handle = (_smch)				\
 		}
 
+/*
+ * Descriptor of a fast path handler for a single fast SMC function ID. The
+ * handler is called directly by the SMC handler for this function ID, bypassing
+ * the dispatch done by the handler of the runtime service owning the ID. The
+ * runtime service must still handle the function ID, as the fast path handler
+ * is only used when it gets a slot of its own in 'rt_svc_fast_fns'.
+ */
+typedef struct rt_svc_fast_fn_desc {
+	uint32_t smc_fid;
+	const char *name;
+	rt_svc_handle_t handle;
+} rt_svc_fast_fn_desc_t;
+
+/* Slot of the 'rt_svc_fast_fns' table looked up by the SMC handler */
+typedef struct rt_svc_fast_fn {
+	uint32_t smc_fid;
+	rt_svc_handle_t handle;
+} rt_svc_fast_fn_t;
+
+/*
+ * Convenience macro to declare a fast path handler
+ */
+#define DECLARE_RT_SVC_FAST_FN(_name, _fid, _smch)			\
+	static const rt_svc_fast_fn_desc_t __svc_fast_fn_ ## _name	\
+		__section("rt_svc_fast_fns") __used = {			\
+			.smc_fid = (_fid),				\
+			.name = #_name,					\
+			.handle = (_smch)				\
+		}
+
 /*
  * Compile time assertions related to the 'rt_svc_desc' structure to:
  * 1. ensure that the assembler and the compiler view of the size
@@ -97,6 +135,23 @@ CASSERT(RT_SVC_DESC_INIT == __builtin_offsetof(rt_svc_desc_t, init), \
 CASSERT(RT_SVC_DESC_HANDLE == __builtin_offsetof(rt_svc_desc_t, handle), \
 	assert_rt_svc_desc_handle_offset_mismatch);
 
+#ifdef __aarch64__
+CASSERT((sizeof(rt_svc_fast_fn_t) == (U(1) << RT_SVC_FAST_FN_SIZE_LOG2)), \
+	assert_sizeof_rt_svc_fast_fn_mismatch);
+CASSERT(RT_SVC_FAST_FN_HANDLE == __builtin_offsetof(rt_svc_fast_fn_t, handle), \
+	assert_rt_svc_fast_fn_handle_offset_mismatch);
+#endif
+
+/*
+ * This function returns the slot of the 'rt_svc_fast_fns' table in which the
+ * fast path handler of an SMC function ID is looked up. It must be kept in sync
+ * with the lookup done by the SMC handler in assembly.
+ */
+static inline uint32_t get_fast_fn_slot_from_smc_fid(uint32_t fid)
+{
+	return (fid ^ (fid >> FUNCID_OEN_SHIFT)) & (RT_SVC_FAST_FN_SLOTS - 1U);
+}
+
 
 /*
  * This function combines the call type and the owning entity number
@@ -130,9 +185,16 @@ uintptr_t handle_runtime_svc(uint32_t smc_fid, void *cookie, void *handle,
 						unsigned int flags);
 IMPORT_SYM(uintptr_t, __RT_SVC_DESCS_START__,		RT_SVC_DESCS_START);
 IMPORT_SYM(uintptr_t, __RT_SVC_DESCS_END__,		RT_SVC_DESCS_END);
+#if ENABLE_SMC_FAST_PATH
+IMPORT_SYM(uintptr_t, __RT_SVC_FAST_FNS_START__,	RT_SVC_FAST_FNS_START);
+IMPORT_SYM(uintptr_t, __RT_SVC_FAST_FNS_END__,		RT_SVC_FAST_FNS_END);
+#endif
 void init_crash_reporting(void);
 
 extern uint8_t rt_svc_descs_indices[MAX_RT_SVCS];
+#if ENABLE_SMC_FAST_PATH
+extern rt_svc_fast_fn_t rt_svc_fast_fns[RT_SVC_FAST_FN_SLOTS];
+#endif
 
 #endif /*__ASSEMBLER__*/
 #endif /* RUNTIME_SVC_H */
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2020, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef TF_LOG_BIN_H
+#define TF_LOG_BIN_H
+
+#include <stdarg.h>
+#include <stdint.h>
+
+#include <platform_def.h>
+
+#include <lib/utils_def.h>
+
+/*
+ * Size in bytes of the binary log, header included. Once it is full, the
+ * records which don't fit are dropped and counted in the header.
+ */
+#ifndef PLAT_TF_LOG_BIN_SIZE
+#define PLAT_TF_LOG_BIN_SIZE		U(0x1000)
+#endif
+
+/* Maximum number of characters recorded for each string argument */
+#define TF_LOG_BIN_MAX_STR_LEN		U(63)
+
+#define TF_LOG_BIN_MAGIC		U(0x4c424654)	/* "TFBL" */
+#define TF_LOG_BIN_VERSION		U(1)
+
+/*
+ * Identifier of each image in the records it writes. The decoder matches it
+ * with the value of the 'tf_log_bin_image' symbol of the ELF files it is given.
+ */
+#define TF_LOG_BIN_IMAGE_BL1		U(1)
+#define TF_LOG_BIN_IMAGE_BL2		U(2)
+#define TF_LOG_BIN_IMAGE_BL2U		U(3)
+#define TF_LOG_BIN_IMAGE_BL31		U(31)
+#define TF_LOG_BIN_IMAGE_BL32		U(32)
+
+/*
+ * Header of the binary log. It is followed by 'used' bytes of records, which
+ * are packed without any padding and use the following little-endian layout:
+ *
+ *   uint16_t	Size of the record in bytes, this field included.
+ *   uint8_t	Identifier of the image which wrote the record.
+ *   uint8_t	Reserved, zero.
+ *   int32_t	Address of the format string passed to tf_log(), relative to
+ *		the address of the 'tf_log_bin_image' symbol of the image.
+ *   ...	Arguments of the format string, in order. Integers and pointers
+ *		take 8 bytes and strings are recorded up to their terminating
+ *		NUL character, truncated to TF_LOG_BIN_MAX_STR_LEN characters.
+ */
+typedef struct tf_log_bin_hdr {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t size;
+	uint32_t used;
+	uint32_t dropped;
+	uint32_t reserved;
+} tf_log_bin_hdr_t;
+
+#define TF_LOG_BIN_RECORD_HDR_SIZE	U(8)
+
+void tf_log_bin(const char *fmt, va_list args);
+
+#endif /* TF_LOG_BIN_H */
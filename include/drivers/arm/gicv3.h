@@ -379,6 +379,8 @@ unsigned int gicv3_get_interrupt_type(unsigned int id,
 					  unsigned int proc_num);
 void gicv3_distif_init_restore(const gicv3_dist_ctx_t * const dist_ctx);
 void gicv3_distif_save(gicv3_dist_ctx_t * const dist_ctx);
+void gicv3_distif_get_ctx_accesses(unsigned int *save_accesses,
+				   unsigned int *restore_accesses);
 /*
  * gicv3_distif_post_restore and gicv3_distif_pre_save must be implemented if
  * gicv3_distif_save and gicv3_rdistif_init_restore are used. If no
@@ -37,6 +37,9 @@ int auth_mod_get_parent_id(unsigned int img_id, unsigned int *parent_id);
 int auth_mod_verify_img(unsigned int img_id,
 			void *img_ptr,
 			unsigned int img_len);
+int auth_mod_hash_start(unsigned int img_id);
+void auth_mod_hash_update(void *ptr, unsigned int len);
+void auth_mod_hash_abort(void);
 
 /* Macro to register a CoT defined as an array of auth_img_desc_t pointers */
 #define REGISTER_COT(_cot) \
@@ -13,7 +13,8 @@ enum crypto_ret_value {
 	CRYPTO_ERR_INIT,
 	CRYPTO_ERR_HASH,
 	CRYPTO_ERR_SIGNATURE,
-	CRYPTO_ERR_UNKNOWN
+	CRYPTO_ERR_UNKNOWN,
+	CRYPTO_ERR_NOT_SUPPORTED
 };
 
 /*
@@ -37,6 +38,16 @@ typedef struct crypto_lib_desc_s {
 	/* Verify a hash. Return one of the 'enum crypto_ret_value' options */
 	int (*verify_hash)(void *data_ptr, unsigned int data_len,
 			   void *digest_info_ptr, unsigned int digest_info_len);
+
+	/* Calculate a hash incrementally and verify it. These are optional
+	 * and may be NULL if the library doesn't support incremental hashing.
+	 * 'hash_init' takes the algorithm from the DigestInfo and 'hash_final'
+	 * compares the result with its digest. Only one hash calculation is in
+	 * progress at a time. Return one of the 'enum crypto_ret_value'
+	 * options */
+	int (*hash_init)(void *digest_info_ptr, unsigned int digest_info_len);
+	int (*hash_update)(void *data_ptr, unsigned int data_len);
+	int (*hash_final)(void *digest_info_ptr, unsigned int digest_info_len);
 } crypto_lib_desc_t;
 
 /* Public functions */
@@ -47,14 +58,21 @@ int crypto_mod_verify_signature(void *data_ptr, unsigned int data_len,
 				void *pk_ptr, unsigned int pk_len);
 int crypto_mod_verify_hash(void *data_ptr, unsigned int data_len,
 			   void *digest_info_ptr, unsigned int digest_info_len);
+int crypto_mod_hash_init(void *digest_info_ptr, unsigned int digest_info_len);
+int crypto_mod_hash_update(void *data_ptr, unsigned int data_len);
+int crypto_mod_hash_final(void *digest_info_ptr, unsigned int digest_info_len);
 
 /* Macro to register a cryptographic library */
-#define REGISTER_CRYPTO_LIB(_name, _init, _verify_signature, _verify_hash) \
+#define REGISTER_CRYPTO_LIB(_name, _init, _verify_signature, _verify_hash, \
+			    _hash_init, _hash_update, _hash_final) \
 	const crypto_lib_desc_t crypto_lib_desc = { \
 		.name = _name, \
 		.init = _init, \
 		.verify_signature = _verify_signature, \
-		.verify_hash = _verify_hash \
+		.verify_hash = _verify_hash, \
+		.hash_init = _hash_init, \
+		.hash_update = _hash_update, \
+		.hash_final = _hash_final \
 	}
 
 extern const crypto_lib_desc_t crypto_lib_desc;
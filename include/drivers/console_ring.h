@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2020, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef CONSOLE_RING_H
+#define CONSOLE_RING_H
+
+#include <stdint.h>
+
+#include <platform_def.h>
+
+#include <lib/utils_def.h>
+
+/*
+ * Size in bytes of the ring of each CPU. It must be a power of two. Once a ring
+ * is full, the oldest characters it holds are overwritten.
+ */
+#ifndef PLAT_CONSOLE_RING_SIZE
+#define PLAT_CONSOLE_RING_SIZE		U(1024)
+#endif
+
+/*
+ * Maximum number of characters of the other CPUs written to the consoles by the
+ * drain done at the end of each line, after those of the calling CPU, to bound
+ * the time a CPU spends waiting on a slow console.
+ */
+#ifndef PLAT_CONSOLE_RING_DRAIN_BUDGET
+#define PLAT_CONSOLE_RING_DRAIN_BUDGET	U(64)
+#endif
+
+#define CONSOLE_RING_MAGIC		U(0x474e5243)	/* "CRNG" */
+#define CONSOLE_RING_VERSION		U(1)
+
+/*
+ * Layout of the memory region holding the rings, as seen by the Non-secure
+ * world. The header is followed, at 'data_offset' bytes from its start, by the
+ * 'num_rings' rings of 'ring_size' bytes each, ring 'n' belonging to the CPU
+ * whose plat_my_core_pos() is 'n'. 'head[n]' is the total number of characters
+ * ever written into ring 'n'. The most recent of them is at offset
+ * '(head[n] - 1) % ring_size' of the ring, and the ring holds the last
+ * 'MIN(head[n], ring_size)' of them.
+ */
+typedef struct console_ring_hdr {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t num_rings;
+	uint32_t ring_size;
+	uint32_t data_offset;
+	uint32_t reserved;
+	uint64_t head[PLATFORM_CORE_COUNT];
+} console_ring_hdr_t;
+
+#define CONSOLE_RING_DATA_OFFSET					\
+	round_up(sizeof(console_ring_hdr_t), CACHE_WRITEBACK_GRANULE)
+
+/* Size of the memory region described above */
+#define CONSOLE_RING_REGION_SIZE					\
+	(CONSOLE_RING_DATA_OFFSET +					\
+	 (PLATFORM_CORE_COUNT * PLAT_CONSOLE_RING_SIZE))
+
+/*
+ * Initialise the ring header, called when entering the runtime state. The
+ * buffered characters are written to the consoles through 'output'.
+ */
+void console_ring_init(int (*output)(int c));
+/*
+ * Write a character into the ring of the calling CPU. Return 0 on success, or
+ * -1 if the ring cannot be used and the character must be written to the
+ * consoles directly.
+ */
+int console_ring_putc(int c);
+/*
+ * Write all the characters buffered by the calling CPU to the consoles, then at
+ * most 'budget' characters buffered by the other CPUs. Waits for another CPU
+ * draining the rings, if any, to be done first.
+ */
+void console_ring_drain(unsigned int budget);
+/* Write all the buffered characters to the consoles. */
+void console_ring_flush(void);
+/*
+ * Same as console_ring_drain() without a budget, called from panic(). It does
+ * not take the drain lock as its owner may never release it.
+ */
+void console_ring_panic_drain(void);
+
+#endif /* CONSOLE_RING_H */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2016-2020, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -7,6 +7,8 @@
 #ifndef IO_BLOCK_H
 #define IO_BLOCK_H
 
+#include <stdbool.h>
+
 #include <drivers/io/io_storage.h>
 
 /* block devices ops */
@@ -19,6 +21,13 @@ typedef struct io_block_dev_spec {
 	io_block_spec_t	buffer;
 	io_block_ops_t	ops;
 	size_t		block_size;
+	/*
+	 * Set if the ops accept any buffer aligned on block_size, and not only
+	 * the device buffer, e.g. because they do the cache maintenance needed
+	 * for DMA on the buffer they are given. Aligned blocks are then
+	 * transferred directly to and from the caller's buffer.
+	 */
+	bool		direct;
 } io_block_dev_spec_t;
 
 struct io_dev_connector;
@@ -14,6 +14,7 @@
 #define __unused	__attribute__((__unused__))
 #define __aligned(x)	__attribute__((__aligned__(x)))
 #define __section(x)	__attribute__((__section__(x)))
+#define __may_alias	__attribute__((__may_alias__))
 #if RECLAIM_INIT_CODE
 /*
  * Add each function to a section that is unique so the functions can still
@@ -0,0 +1,20 @@
+/*
+ * Copyright (c) 2020, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef TF_UNLZ4_H
+#define TF_UNLZ4_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* First bytes of an LZ4 frame, see image_decompress_add_format() */
+#define LZ4_MAGIC		"\x04\x22\x4d\x18"
+#define LZ4_MAGIC_LEN		4U
+
+int unlz4(uintptr_t *in_buf, size_t in_len, uintptr_t *out_buf,
+	  size_t out_len, uintptr_t work_buf, size_t work_len);
+
+#endif /* TF_UNLZ4_H */
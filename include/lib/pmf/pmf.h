@@ -40,7 +40,24 @@
  */
 #define PMF_SMC_GET_TIMESTAMP_32	U(0x82000010)
 #define PMF_SMC_GET_TIMESTAMP_64	U(0xC2000010)
+#define PMF_SMC_GET_SMC_LATENCY_64	U(0xC2000011)
+#if ENABLE_SMC_LATENCY_STATS
+#define PMF_NUM_SMC_CALLS		3
+#else
 #define PMF_NUM_SMC_CALLS		2
+#endif
+
+/*
+ * Number of log2 buckets of the SMC latency histograms, and number of SMC
+ * function IDs which get a histogram of their own on each CPU.
+ */
+#define PMF_SMC_LAT_NUM_BUCKETS		U(24)
+#ifndef PLAT_PMF_SMC_LAT_NUM_FIDS
+#define PLAT_PMF_SMC_LAT_NUM_FIDS	U(16)
+#endif
+
+/* Function ID reported for the histogram of all the other SMCs */
+#define PMF_SMC_LAT_OTHER_FID		U(0xFFFFFFFF)
 
 /*
  * The macros below are used to identify
@@ -174,4 +191,9 @@ uintptr_t pmf_smc_handler(unsigned int smc_fid,
 		void *handle,
 		u_register_t flags);
 
+/* SMC latency histograms */
+void pmf_smc_latency_record(uint32_t smc_fid, uint64_t ticks);
+uintptr_t pmf_smc_latency_smc_handler(u_register_t x1, u_register_t x2,
+		u_register_t x3, void *handle);
+
 #endif /* PMF_H */
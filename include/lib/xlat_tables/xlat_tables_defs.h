@@ -108,6 +108,16 @@
 #define XLAT_BLOCK_MASK(level)	(XLAT_BLOCK_SIZE(level) - UL(1))
 /* Mask to get the address bits common to a block of a certain table level*/
 #define XLAT_ADDR_MASK(level)	(~XLAT_BLOCK_MASK(level))
+/*
+ * Number of adjacent translation table entries that the Contiguous hint groups
+ * together when using the 4KB translation granule. Their VA and PA must be
+ * aligned to the size of the group.
+ */
+#define XLAT_CONT_ENTRIES_SHIFT	U(4)
+#define XLAT_CONT_ENTRIES	(U(1) << XLAT_CONT_ENTRIES_SHIFT)
+#define XLAT_CONT_SIZE(level)	(XLAT_BLOCK_SIZE(level) << XLAT_CONT_ENTRIES_SHIFT)
+#define XLAT_CONT_MASK(level)	(XLAT_CONT_SIZE(level) - UL(1))
+
 /*
  * Extract from the given virtual address the index into the given lookup level.
  * This macro assumes the system is using the 4KB translation granule.
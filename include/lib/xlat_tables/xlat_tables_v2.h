@@ -310,13 +310,18 @@ int mmap_remove_dynamic_region_ctx(xlat_ctx_t *ctx,
  *
  * The base address of the memory region must be aligned on a page boundary.
  * The size of this memory region must be a multiple of a page size.
- * The memory region must be already mapped by the given translation tables
- * and it must be mapped at the granularity of a page.
+ * The memory region must be already mapped by the given translation tables.
+ *
+ * Block descriptors that are only partially covered by the memory region are
+ * split into finer descriptors, which needs free translation tables. If
+ * PLAT_XLAT_TABLES_DYNAMIC is enabled, tables that end up mapping memory with
+ * the same attributes everywhere are coalesced back into block descriptors
+ * when the mmap region they belong to allows it, and released.
  *
  * Return 0 on success, a negative value on error.
  *
- * In case of error, the memory attributes remain unchanged and this function
- * has no effect.
+ * In case of error, the memory attributes remain unchanged, but some blocks
+ * might have been split into equivalent finer mappings.
  *
  * ctx
  *   Translation context to work on.
@@ -340,8 +345,18 @@ int mmap_remove_dynamic_region_ctx(xlat_ctx_t *ctx,
  * NOTE2: The caller is responsible for making sure that the targeted
  * translation tables are not modified by any other code while this function is
  * executing.
+ *
+ * NOTE3: Splitting or coalescing a block, or clearing the Contiguous hint of a
+ * group of entries that the memory region only partially covers, briefly
+ * unmaps all the memory they cover, not only the memory region. If the context
+ * is the one in use, this is refused for the blocks and groups that cover the
+ * code of the image, the stack of the current CPU, or the context and its
+ * translation tables, and the function returns -EPERM. The caller must not
+ * access the rest of that memory while this function runs. None of this
+ * happens when changing the attributes of whole blocks or of whole mmap
+ * regions.
  */
-int xlat_change_mem_attributes_ctx(const xlat_ctx_t *ctx, uintptr_t base_va,
+int xlat_change_mem_attributes_ctx(xlat_ctx_t *ctx, uintptr_t base_va,
 				   size_t size, uint32_t attr);
 int xlat_change_mem_attributes(uintptr_t base_va, size_t size, uint32_t attr);
 
@@ -58,10 +58,12 @@ struct xlat_ctx {
 	 * regions. The list is terminated by the first entry with size == 0.
 	 * The max size of the list is stored in `mmap_num`. `mmap` points to an
 	 * array of mmap_num + 1 elements, so that there is space for the final
-	 * null entry.
+	 * null entry. The number of regions currently in the list is stored in
+	 * `mmap_regions`, which allows to look them up by binary search.
 	 */
 	struct mmap_region *mmap;
 	int mmap_num;
+	int mmap_regions;
 
 	/*
 	 * Array of finer-grain translation tables.
@@ -146,6 +148,7 @@ struct xlat_ctx {
 		.pa_max_address = (_phy_addr_space_size) - 1ULL,	\
 		.mmap = _ctx_name##_mmap,				\
 		.mmap_num = (_mmap_count),				\
+		.mmap_regions = 0,					\
 		.base_level = GET_XLAT_TABLE_LEVEL_BASE(_virt_addr_space_size),\
 		.base_table = _ctx_name##_base_xlat_table,		\
 		.base_table_entries =					\
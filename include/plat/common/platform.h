@@ -195,6 +195,7 @@ void bl2_el3_plat_arch_setup(void);
  * Optional BL2 at EL3 functions (may be overridden)
  ******************************************************************************/
 void bl2_el3_plat_prepare_exit(void);
+int bl2_el3_plat_release_secondary(uintptr_t entrypoint);
 
 /*******************************************************************************
  * Mandatory BL2U functions.
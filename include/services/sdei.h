@@ -117,8 +117,16 @@
 	SDEI_EVENT_MAP((_event), 0, (_pri) | SDEI_MAPF_EXPLICIT | SDEI_MAPF_PRIVATE)
 
 /*
- * Declare shared and private entries for each core. Also declare a global
- * structure containing private and share entries.
+ * Number of slots of the hash table used to look up event mappings by event
+ * number. Keeping it at most half full bounds the length of the probe
+ * sequences.
+ */
+#define SDEI_EVENT_LOOKUP_SLOTS(_num_maps)	(2U * (_num_maps))
+
+/*
+ * Declare shared and private entries for each core, and the hash table to look
+ * up events by number. Also declare a global structure containing private and
+ * share entries.
  *
  * This macro must be used in the same file as the platform SDEI mappings are
  * declared. Only then would ARRAY_SIZE() yield a meaningful value.
@@ -127,6 +135,10 @@
 	sdei_entry_t sdei_private_event_table \
 		[PLATFORM_CORE_COUNT * ARRAY_SIZE(_private)]; \
 	sdei_entry_t sdei_shared_event_table[ARRAY_SIZE(_shared)]; \
+	sdei_ev_map_t *sdei_event_lookup_table[SDEI_EVENT_LOOKUP_SLOTS( \
+			ARRAY_SIZE(_private) + ARRAY_SIZE(_shared))]; \
+	const unsigned int sdei_event_lookup_slots = SDEI_EVENT_LOOKUP_SLOTS( \
+			ARRAY_SIZE(_private) + ARRAY_SIZE(_shared)); \
 	const sdei_mapping_t sdei_global_mappings[] = { \
 		[SDEI_MAP_IDX_PRIV_] = { \
 			.map = (_private), \
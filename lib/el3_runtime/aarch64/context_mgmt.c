@@ -26,6 +26,19 @@
 #include <plat/common/platform.h>
 #include <smccc_helpers.h>
 
+#if CTX_LAZY_FPREGS
+/*
+ * Security state whose values are held by the FP/SIMD registers of each CPU,
+ * encoded with FPREGS_OWNER(), or FPREGS_OWNER_NONE if their values need not
+ * be saved. When CPTR_EL3.TFP is clear, the registers belong to the security
+ * state running on the CPU.
+ */
+#define FPREGS_OWNER_NONE		U(0)
+#define FPREGS_OWNER(_state)		((_state) + U(1))
+#define FPREGS_OWNER_STATE(_owner)	((_owner) - U(1))
+
+static uint32_t fpregs_owner[PLATFORM_CORE_COUNT];
+#endif
 
 /*******************************************************************************
  * Context management library initialisation routine. This library is used by
@@ -561,6 +574,139 @@ void cm_el1_sysregs_context_restore(uint32_t security_state)
 #endif
 }
 
+#if CTX_INCLUDE_FPREGS
+#if CTX_LAZY_FPREGS
+static bool fpregs_trapped(void)
+{
+	return (read_cptr_el3() & TFP_BIT) != 0U;
+}
+
+static void fpregs_set_trap(bool trap)
+{
+	u_register_t cptr_el3 = read_cptr_el3();
+
+	if (trap)
+		cptr_el3 |= TFP_BIT;
+	else
+		cptr_el3 &= ~TFP_BIT;
+
+	write_cptr_el3(cptr_el3);
+	isb();
+}
+
+/*******************************************************************************
+ * This function saves the FP/SIMD registers of the CPU to the context of the
+ * security state owning them, if any, and leaves the registers without owner.
+ * It must run with CPTR_EL3.TFP clear.
+ ******************************************************************************/
+static void fpregs_flush(unsigned int cpu_idx)
+{
+	cpu_context_t *ctx;
+
+	if (fpregs_owner[cpu_idx] == FPREGS_OWNER_NONE)
+		return;
+
+	ctx = cm_get_context(FPREGS_OWNER_STATE(fpregs_owner[cpu_idx]));
+	assert(ctx != NULL);
+
+	fpregs_context_save(get_fpregs_ctx(ctx));
+	fpregs_owner[cpu_idx] = FPREGS_OWNER_NONE;
+}
+
+/*******************************************************************************
+ * Handler of the FP/SIMD access traps taken to EL3 while the FP/SIMD registers
+ * belong to the other security state. The registers are switched to the
+ * current security state, and the trapped instruction is then executed again.
+ ******************************************************************************/
+void cm_fpregs_trap_handler(void)
+{
+	unsigned int cpu_idx = plat_my_core_pos();
+	uint32_t security_state = ((read_scr_el3() & SCR_NS_BIT) != 0U) ?
+		NON_SECURE : SECURE;
+	cpu_context_t *ctx = cm_get_context(security_state);
+
+	assert(ctx != NULL);
+
+	fpregs_set_trap(false);
+	fpregs_flush(cpu_idx);
+	fpregs_context_restore(get_fpregs_ctx(ctx));
+	fpregs_owner[cpu_idx] = FPREGS_OWNER(security_state);
+}
+
+/*******************************************************************************
+ * The FP/SIMD registers are lost when the CPU is powered down, so save them to
+ * the context of their owner first. The trap setting is left untouched in case
+ * the power down is aborted.
+ ******************************************************************************/
+static void *fpregs_pwrdown_start(const void *arg)
+{
+	bool trapped = fpregs_trapped();
+
+	if (trapped)
+		fpregs_set_trap(false);
+
+	fpregs_flush(plat_my_core_pos());
+
+	if (trapped)
+		fpregs_set_trap(true);
+
+	return (void *)0;
+}
+
+/* The FP/SIMD registers hold no values of interest once the CPU is powered up */
+static void *fpregs_cpu_on_finish(const void *arg)
+{
+	fpregs_owner[plat_my_core_pos()] = FPREGS_OWNER_NONE;
+
+	return (void *)0;
+}
+
+SUBSCRIBE_TO_EVENT(psci_suspend_pwrdown_start, fpregs_pwrdown_start);
+SUBSCRIBE_TO_EVENT(psci_cpu_on_finish, fpregs_cpu_on_finish);
+#endif /* CTX_LAZY_FPREGS */
+
+/*******************************************************************************
+ * The next two functions are used by runtime services to save and restore the
+ * FP/SIMD registers on the 'cpu_context' structure for the specified security
+ * state, around a switch to the other security state.
+ *
+ * With CTX_LAZY_FPREGS, the registers are not switched here. They are left in
+ * place, and the first access to them by a security state which does not own
+ * them is trapped to EL3, where they are switched by cm_fpregs_trap_handler().
+ ******************************************************************************/
+void cm_fpregs_context_save(uint32_t security_state)
+{
+#if CTX_LAZY_FPREGS
+	/* The security state owns the registers if it could access them */
+	if (!fpregs_trapped())
+		fpregs_owner[plat_my_core_pos()] = FPREGS_OWNER(security_state);
+#else
+	cpu_context_t *ctx;
+
+	ctx = cm_get_context(security_state);
+	assert(ctx != NULL);
+
+	fpregs_context_save(get_fpregs_ctx(ctx));
+#endif
+}
+
+void cm_fpregs_context_restore(uint32_t security_state)
+{
+#if CTX_LAZY_FPREGS
+	/* Trap accesses to the registers if they belong to another owner */
+	fpregs_set_trap(fpregs_owner[plat_my_core_pos()] !=
+			FPREGS_OWNER(security_state));
+#else
+	cpu_context_t *ctx;
+
+	ctx = cm_get_context(security_state);
+	assert(ctx != NULL);
+
+	fpregs_context_restore(get_fpregs_ctx(ctx));
+#endif
+}
+#endif /* CTX_INCLUDE_FPREGS */
+
 /*******************************************************************************
  * This function populates ELR_EL3 member of 'cpu_context' pertaining to the
  * given security state with the given entrypoint
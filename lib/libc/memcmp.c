@@ -4,9 +4,17 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#include <cdefs.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <string.h>
 
+/* Natural word of the architecture, allowed to alias any other type */
+typedef unsigned long __may_alias word_t;
+
+#define WORD_SIZE	sizeof(word_t)
+#define WORD_MASK	(WORD_SIZE - 1U)
+
 int memcmp(const void *s1, const void *s2, size_t len)
 {
 	const unsigned char *s = s1;
@@ -14,6 +22,27 @@ int memcmp(const void *s1, const void *s2, size_t len)
 	unsigned char sc;
 	unsigned char dc;
 
+	/*
+	 * Skip over equal words when both buffers have the same alignment
+	 * within a word. The first difference is then located byte by byte.
+	 */
+	if ((((uintptr_t)s ^ (uintptr_t)d) & WORD_MASK) == 0U) {
+		while ((((uintptr_t)s & WORD_MASK) != 0U) && (len != 0U)) {
+			sc = *s++;
+			dc = *d++;
+			if (sc - dc)
+				return (sc - dc);
+			len--;
+		}
+
+		while ((len >= WORD_SIZE) &&
+		       (*(const word_t *)s == *(const word_t *)d)) {
+			s += WORD_SIZE;
+			d += WORD_SIZE;
+			len -= WORD_SIZE;
+		}
+	}
+
 	while (len--) {
 		sc = *s++;
 		dc = *d++;
@@ -4,14 +4,62 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#include <cdefs.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <string.h>
 
+/* Natural word of the architecture, allowed to alias any other type */
+typedef unsigned long __may_alias word_t;
+
+#define WORD_SIZE	sizeof(word_t)
+#define WORD_MASK	(WORD_SIZE - 1U)
+
 void *memcpy(void *dst, const void *src, size_t len)
 {
 	const char *s = src;
 	char *d = dst;
 
+	/*
+	 * Copy a word at a time when both buffers have the same alignment
+	 * within a word. Only aligned accesses are used, so this is also safe
+	 * on memory that doesn't allow unaligned accesses.
+	 */
+	if ((((uintptr_t)d ^ (uintptr_t)s) & WORD_MASK) == 0U) {
+		const word_t *ws;
+		word_t *wd;
+
+		while ((((uintptr_t)d & WORD_MASK) != 0U) && (len != 0U)) {
+			*d++ = *s++;
+			len--;
+		}
+
+		ws = (const word_t *)s;
+		wd = (word_t *)d;
+
+		while (len >= (8U * WORD_SIZE)) {
+			wd[0] = ws[0];
+			wd[1] = ws[1];
+			wd[2] = ws[2];
+			wd[3] = ws[3];
+			wd[4] = ws[4];
+			wd[5] = ws[5];
+			wd[6] = ws[6];
+			wd[7] = ws[7];
+			wd += 8;
+			ws += 8;
+			len -= 8U * WORD_SIZE;
+		}
+
+		while (len >= WORD_SIZE) {
+			*wd++ = *ws++;
+			len -= WORD_SIZE;
+		}
+
+		s = (const char *)ws;
+		d = (char *)wd;
+	}
+
 	while (len--)
 		*d++ = *s++;
 
@@ -1,11 +1,19 @@
 /*
- * Copyright (c) 2013-2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2013-2020, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#include <cdefs.h>
+#include <stdint.h>
 #include <string.h>
 
+/* Natural word of the architecture, allowed to alias any other type */
+typedef unsigned long __may_alias word_t;
+
+#define WORD_SIZE	sizeof(word_t)
+#define WORD_MASK	(WORD_SIZE - 1U)
+
 void *memmove(void *dst, const void *src, size_t len)
 {
 	/*
@@ -24,6 +32,42 @@ void *memmove(void *dst, const void *src, size_t len)
 		const char *end = dst;
 		const char *s = (const char *)src + len;
 		char *d = (char *)dst + len;
+
+		/*
+		 * A word at a time when both buffers have the same alignment
+		 * within a word, see memcpy().
+		 */
+		if ((((uintptr_t)d ^ (uintptr_t)s) & WORD_MASK) == 0U) {
+			const word_t *ws;
+			word_t *wd;
+
+			while ((((uintptr_t)d & WORD_MASK) != 0U) &&
+			       (d != end))
+				*--d = *--s;
+
+			ws = (const word_t *)s;
+			wd = (word_t *)d;
+
+			while ((size_t)((char *)wd - end) >= (8U * WORD_SIZE)) {
+				wd -= 8;
+				ws -= 8;
+				wd[7] = ws[7];
+				wd[6] = ws[6];
+				wd[5] = ws[5];
+				wd[4] = ws[4];
+				wd[3] = ws[3];
+				wd[2] = ws[2];
+				wd[1] = ws[1];
+				wd[0] = ws[0];
+			}
+
+			while ((size_t)((char *)wd - end) >= WORD_SIZE)
+				*--wd = *--ws;
+
+			s = (const char *)ws;
+			d = (char *)wd;
+		}
+
 		while (d != end)
 			*--d = *--s;
 	}
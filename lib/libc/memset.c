@@ -4,12 +4,52 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#include <cdefs.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <string.h>
 
+/* Natural word of the architecture, allowed to alias any other type */
+typedef unsigned long __may_alias word_t;
+
+#define WORD_SIZE	sizeof(word_t)
+#define WORD_MASK	(WORD_SIZE - 1U)
+
 void *memset(void *dst, int val, size_t count)
 {
 	char *ptr = dst;
+	word_t *wptr;
+	word_t pattern;
+
+	/* Fill up to the first word boundary */
+	while ((((uintptr_t)ptr & WORD_MASK) != 0U) && (count != 0U)) {
+		*ptr++ = val;
+		count--;
+	}
+
+	/* Replicate the byte value into every byte of a word */
+	pattern = (word_t)(unsigned char)val * (~(word_t)0 / 0xFFU);
+	wptr = (word_t *)ptr;
+
+	while (count >= (8U * WORD_SIZE)) {
+		wptr[0] = pattern;
+		wptr[1] = pattern;
+		wptr[2] = pattern;
+		wptr[3] = pattern;
+		wptr[4] = pattern;
+		wptr[5] = pattern;
+		wptr[6] = pattern;
+		wptr[7] = pattern;
+		wptr += 8;
+		count -= 8U * WORD_SIZE;
+	}
+
+	while (count >= WORD_SIZE) {
+		*wptr++ = pattern;
+		count -= WORD_SIZE;
+	}
+
+	ptr = (char *)wptr;
 
 	while (count--)
 		*ptr++ = val;
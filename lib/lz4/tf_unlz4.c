@@ -0,0 +1,362 @@
+/*
+ * Copyright (c) 2020, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <common/debug.h>
+#include <tf_unlz4.h>
+
+/*
+ * Decoder for the LZ4 frame format, as produced by the 'lz4' command line tool.
+ * See https://github.com/lz4/lz4/blob/dev/doc/lz4_Frame_format.md and
+ * https://github.com/lz4/lz4/blob/dev/doc/lz4_Block_format.md
+ *
+ * The whole output is decoded into a single contiguous buffer, so blocks that
+ * reference data of previous blocks are supported without a separate window.
+ * Dictionaries are not supported.
+ */
+
+#define LZ4_FRAME_MAGIC		0x184D2204U
+
+/* Frame descriptor FLG byte */
+#define LZ4_FLG_VERSION_MASK	0xC0U
+#define LZ4_FLG_VERSION		0x40U
+#define LZ4_FLG_BLOCK_CHECKSUM	(1U << 4)
+#define LZ4_FLG_CONTENT_SIZE	(1U << 3)
+#define LZ4_FLG_CONTENT_CHECKSUM (1U << 2)
+#define LZ4_FLG_RESERVED	(1U << 1)
+#define LZ4_FLG_DICT_ID		(1U << 0)
+
+/* Frame descriptor BD byte */
+#define LZ4_BD_BLOCK_MAX_SHIFT	4
+#define LZ4_BD_BLOCK_MAX_MASK	0x7U
+#define LZ4_BD_BLOCK_MAX_64K	4U	/* IDs 0 to 3 are reserved */
+#define LZ4_BD_RESERVED		0x8FU
+
+/* Block size field */
+#define LZ4_BLOCK_UNCOMPRESSED	(1U << 31)
+
+/* Block format */
+#define LZ4_MIN_MATCH		4U
+#define LZ4_RUN_MASK		0xFU
+
+/* xxHash32 constants */
+#define XXH_PRIME32_1		2654435761U
+#define XXH_PRIME32_2		2246822519U
+#define XXH_PRIME32_3		3266489917U
+#define XXH_PRIME32_4		668265263U
+#define XXH_PRIME32_5		374761393U
+
+static inline uint32_t read_le32(const uint8_t *p)
+{
+	return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+	       ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline uint32_t rotl32(uint32_t x, unsigned int r)
+{
+	return (x << r) | (x >> (32U - r));
+}
+
+static inline uint32_t xxh32_round(uint32_t acc, uint32_t input)
+{
+	acc += input * XXH_PRIME32_2;
+	acc = rotl32(acc, 13);
+	return acc * XXH_PRIME32_1;
+}
+
+/* xxHash32 with a seed of zero, as used by the frame format checksums */
+static uint32_t xxh32(const uint8_t *p, size_t len)
+{
+	const uint8_t *end = p + len;
+	uint32_t h;
+
+	if (len >= 16U) {
+		uint32_t v1 = XXH_PRIME32_1 + XXH_PRIME32_2;
+		uint32_t v2 = XXH_PRIME32_2;
+		uint32_t v3 = 0U;
+		uint32_t v4 = 0U - XXH_PRIME32_1;
+
+		do {
+			v1 = xxh32_round(v1, read_le32(p));
+			v2 = xxh32_round(v2, read_le32(p + 4));
+			v3 = xxh32_round(v3, read_le32(p + 8));
+			v4 = xxh32_round(v4, read_le32(p + 12));
+			p += 16;
+		} while ((size_t)(end - p) >= 16U);
+
+		h = rotl32(v1, 1) + rotl32(v2, 7) + rotl32(v3, 12) +
+		    rotl32(v4, 18);
+	} else {
+		h = XXH_PRIME32_5;
+	}
+
+	h += (uint32_t)len;
+
+	while ((size_t)(end - p) >= 4U) {
+		h += read_le32(p) * XXH_PRIME32_3;
+		h = rotl32(h, 17) * XXH_PRIME32_4;
+		p += 4;
+	}
+
+	while (p < end) {
+		h += *p * XXH_PRIME32_5;
+		h = rotl32(h, 11) * XXH_PRIME32_1;
+		p++;
+	}
+
+	h ^= h >> 15;
+	h *= XXH_PRIME32_2;
+	h ^= h >> 13;
+	h *= XXH_PRIME32_3;
+	h ^= h >> 16;
+
+	return h;
+}
+
+/*
+ * Read a length that is extended with additional bytes when the 4-bit field
+ * in the token is saturated.
+ */
+static int read_length(const uint8_t **ip, const uint8_t *iend, size_t *len)
+{
+	uint8_t b;
+
+	if (*len != LZ4_RUN_MASK) {
+		return 0;
+	}
+
+	do {
+		if (*ip >= iend) {
+			return -EIO;
+		}
+		b = *(*ip)++;
+		*len += b;
+	} while (b == 0xFFU);
+
+	return 0;
+}
+
+/*
+ * Decode a compressed block. 'out_start' is the start of the whole output
+ * buffer, which matches may refer back to. Returns the number of bytes
+ * written at 'op', or a negative error code.
+ */
+static int decode_block(const uint8_t *ip, size_t in_len,
+			const uint8_t *out_start, uint8_t *op,
+			const uint8_t *oend, size_t *out_len)
+{
+	const uint8_t *iend = ip + in_len;
+	uint8_t *ostart = op;
+	size_t len, offset;
+	uint8_t token;
+
+	while (ip < iend) {
+		token = *ip++;
+
+		/* Literals */
+		len = token >> 4;
+		if (read_length(&ip, iend, &len) != 0) {
+			return -EIO;
+		}
+		if ((len > (size_t)(iend - ip)) || (len > (size_t)(oend - op))) {
+			return -EIO;
+		}
+		(void)memcpy(op, ip, len);
+		ip += len;
+		op += len;
+
+		/* The last sequence of a block only has literals */
+		if (ip == iend) {
+			break;
+		}
+
+		/* Match */
+		if ((size_t)(iend - ip) < 2U) {
+			return -EIO;
+		}
+		offset = (size_t)ip[0] | ((size_t)ip[1] << 8);
+		ip += 2;
+		if ((offset == 0U) || (offset > (size_t)(op - out_start))) {
+			return -EIO;
+		}
+
+		len = token & LZ4_RUN_MASK;
+		if (read_length(&ip, iend, &len) != 0) {
+			return -EIO;
+		}
+		len += LZ4_MIN_MATCH;
+		if (len > (size_t)(oend - op)) {
+			return -EIO;
+		}
+
+		/*
+		 * A match that overlaps the data it copies repeats it, so it
+		 * must be copied byte by byte.
+		 */
+		if (offset >= len) {
+			(void)memcpy(op, op - offset, len);
+			op += len;
+		} else {
+			while (len-- != 0U) {
+				*op = *(op - offset);
+				op++;
+			}
+		}
+	}
+
+	*out_len = (size_t)(op - ostart);
+
+	return 0;
+}
+
+/*
+ * unlz4 - decompress LZ4 frame data
+ * @in_buf: source of compressed input. Upon exit, the end of input.
+ * @in_len: length of in_buf
+ * @out_buf: destination of decompressed output. Upon exit, the end of output.
+ * @out_len: length of out_buf
+ * @work_buf: workspace (unused, LZ4 decodes in place in the output)
+ * @work_len: length of workspace
+ */
+int unlz4(uintptr_t *in_buf, size_t in_len, uintptr_t *out_buf,
+	  size_t out_len, uintptr_t work_buf, size_t work_len)
+{
+	const uint8_t *ip = (const uint8_t *)*in_buf;
+	const uint8_t *iend = ip + in_len;
+	const uint8_t *desc;
+	uint8_t *out_start = (uint8_t *)*out_buf;
+	uint8_t *op = out_start;
+	uint8_t *oend = out_start + out_len;
+	size_t block_max, block_len, len;
+	uint32_t block_size;
+	uint8_t flg, bd, block_max_id;
+	bool block_checksum;
+	int ret;
+
+	(void)work_buf;
+	(void)work_len;
+
+	/* Magic number and the FLG and BD bytes of the frame descriptor */
+	if ((in_len < 7U) || (read_le32(ip) != LZ4_FRAME_MAGIC)) {
+		ERROR("lz4: not an LZ4 frame\n");
+		return -EINVAL;
+	}
+	ip += 4;
+	desc = ip;
+
+	flg = *ip++;
+	bd = *ip++;
+	block_max_id = (bd >> LZ4_BD_BLOCK_MAX_SHIFT) & LZ4_BD_BLOCK_MAX_MASK;
+	if (((flg & LZ4_FLG_VERSION_MASK) != LZ4_FLG_VERSION) ||
+	    ((flg & LZ4_FLG_RESERVED) != 0U) ||
+	    ((bd & LZ4_BD_RESERVED) != 0U) ||
+	    (block_max_id < LZ4_BD_BLOCK_MAX_64K)) {
+		ERROR("lz4: unsupported frame descriptor\n");
+		return -EINVAL;
+	}
+
+	if ((flg & LZ4_FLG_DICT_ID) != 0U) {
+		ERROR("lz4: dictionaries are not supported\n");
+		return -EINVAL;
+	}
+
+	block_max = (size_t)1U << (8U + 2U * block_max_id);
+	block_checksum = (flg & LZ4_FLG_BLOCK_CHECKSUM) != 0U;
+
+	/* The content size is only informative, skip it */
+	if ((flg & LZ4_FLG_CONTENT_SIZE) != 0U) {
+		if ((size_t)(iend - ip) < 8U) {
+			return -EIO;
+		}
+		ip += 8;
+	}
+
+	/* Header checksum */
+	if (ip >= iend) {
+		return -EIO;
+	}
+	if (((xxh32(desc, (size_t)(ip - desc)) >> 8) & 0xFFU) != *ip) {
+		ERROR("lz4: frame descriptor checksum mismatch\n");
+		return -EIO;
+	}
+	ip++;
+
+	for (;;) {
+		if ((size_t)(iend - ip) < 4U) {
+			return -EIO;
+		}
+		block_size = read_le32(ip);
+		ip += 4;
+
+		/* EndMark */
+		if (block_size == 0U) {
+			break;
+		}
+
+		len = block_size & ~LZ4_BLOCK_UNCOMPRESSED;
+		if ((len > block_max) || (len > (size_t)(iend - ip))) {
+			ERROR("lz4: invalid block size\n");
+			return -EIO;
+		}
+
+		if (block_checksum) {
+			if (((size_t)(iend - ip) - len) < 4U) {
+				return -EIO;
+			}
+			if (xxh32(ip, len) != read_le32(ip + len)) {
+				ERROR("lz4: block checksum mismatch\n");
+				return -EIO;
+			}
+		}
+
+		if ((block_size & LZ4_BLOCK_UNCOMPRESSED) != 0U) {
+			if (len > (size_t)(oend - op)) {
+				ERROR("lz4: output buffer too small\n");
+				return -ENOMEM;
+			}
+			(void)memcpy(op, ip, len);
+			block_len = len;
+		} else {
+			ret = decode_block(ip, len, out_start, op, oend,
+					   &block_len);
+			if (ret != 0) {
+				ERROR("lz4: corrupted block\n");
+				return ret;
+			}
+		}
+
+		ip += len;
+		op += block_len;
+
+		if (block_checksum) {
+			ip += 4;
+		}
+	}
+
+	if ((flg & LZ4_FLG_CONTENT_CHECKSUM) != 0U) {
+		if ((size_t)(iend - ip) < 4U) {
+			return -EIO;
+		}
+		if (xxh32(out_start, (size_t)(op - out_start)) !=
+		    read_le32(ip)) {
+			ERROR("lz4: content checksum mismatch\n");
+			return -EIO;
+		}
+		ip += 4;
+	}
+
+	VERBOSE("lz4: %lu byte input\n", (unsigned long)(ip - (uint8_t *)*in_buf));
+	VERBOSE("lz4: %lu byte output\n", (unsigned long)(op - out_start));
+
+	*in_buf = (uintptr_t)ip;
+	*out_buf = (uintptr_t)op;
+
+	return 0;
+}
@@ -56,6 +56,11 @@ uintptr_t pmf_smc_handler(unsigned int smc_fid,
 					(unsigned int)x3, &ts_value);
 			SMC_RET2(handle, rc, ts_value);
 		}
+
+#if ENABLE_SMC_LATENCY_STATS
+		if (smc_fid == PMF_SMC_GET_SMC_LATENCY_64)
+			return pmf_smc_latency_smc_handler(x1, x2, x3, handle);
+#endif
 	}
 
 	WARN("Unimplemented PMF Call: 0x%x \n", smc_fid);
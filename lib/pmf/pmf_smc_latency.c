@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2020, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <assert.h>
+#include <errno.h>
+#include <stdint.h>
+
+#include <arch_helpers.h>
+#include <lib/pmf/pmf.h>
+#include <lib/utils_def.h>
+#include <plat/common/platform.h>
+#include <smccc_helpers.h>
+
+/*
+ * Histogram of the time spent by BL31 handling one SMC function ID on one CPU.
+ * Bucket 0 counts calls which took no counter tick at all, and bucket 'n'
+ * counts calls which took [2^(n-1), 2^n) ticks of the system counter. The last
+ * bucket also counts all the longer calls.
+ */
+typedef struct smc_lat_hist {
+	uint32_t smc_fid;
+	uint32_t buckets[PMF_SMC_LAT_NUM_BUCKETS];
+	uint64_t count;
+} smc_lat_hist_t;
+
+/*
+ * Per-CPU histograms. The first PLAT_PMF_SMC_LAT_NUM_FIDS entries form a hash
+ * table keyed by SMC function ID, with free entries having a zero count. Once
+ * it is full, calls to other function IDs are accounted in the last entry.
+ */
+typedef struct smc_lat_cpu_stats {
+	smc_lat_hist_t hist[PLAT_PMF_SMC_LAT_NUM_FIDS + 1U];
+} __aligned(CACHE_WRITEBACK_GRANULE) smc_lat_cpu_stats_t;
+
+static smc_lat_cpu_stats_t smc_lat_stats[PLATFORM_CORE_COUNT];
+
+static unsigned int smc_lat_bucket(uint64_t ticks)
+{
+	unsigned int bucket;
+
+	if (ticks == 0ULL)
+		return 0U;
+
+	bucket = 64U - (unsigned int)__builtin_clzll(ticks);
+
+	return MIN(bucket, PMF_SMC_LAT_NUM_BUCKETS - 1U);
+}
+
+/*
+ * Account an SMC which took 'ticks' system counter ticks to handle. This is
+ * called from the SMC handler in runtime_exceptions.S on the CPU which handled
+ * the SMC, so the per-CPU stats need no locking.
+ */
+void pmf_smc_latency_record(uint32_t smc_fid, uint64_t ticks)
+{
+	smc_lat_hist_t *hist = smc_lat_stats[plat_my_core_pos()].hist;
+	unsigned int i, idx = smc_fid % PLAT_PMF_SMC_LAT_NUM_FIDS;
+
+	for (i = 0U; i < PLAT_PMF_SMC_LAT_NUM_FIDS; i++) {
+		if ((hist[idx].count == 0ULL) || (hist[idx].smc_fid == smc_fid))
+			break;
+
+		idx = (idx + 1U) % PLAT_PMF_SMC_LAT_NUM_FIDS;
+	}
+
+	if (i == PLAT_PMF_SMC_LAT_NUM_FIDS) {
+		/* Table full, account this SMC as another function ID */
+		idx = PLAT_PMF_SMC_LAT_NUM_FIDS;
+		smc_fid = PMF_SMC_LAT_OTHER_FID;
+	}
+
+	hist[idx].smc_fid = smc_fid;
+	hist[idx].buckets[smc_lat_bucket(ticks)]++;
+	hist[idx].count++;
+}
+
+/*
+ * Retrieve the SMC function ID held by histogram 'entry' of the CPU identified
+ * by 'mpidr', its total number of calls, and the number of calls in 'bucket'.
+ * Unused entries report a zero count.
+ */
+static int pmf_smc_latency_get(u_register_t mpidr, unsigned int entry,
+			       unsigned int bucket, uint32_t *smc_fid,
+			       uint64_t *count, uint32_t *bucket_count)
+{
+	const smc_lat_hist_t *hist;
+	int cpu_idx = plat_core_pos_by_mpidr(mpidr);
+
+	if ((cpu_idx < 0) || (entry > PLAT_PMF_SMC_LAT_NUM_FIDS) ||
+	    (bucket >= PMF_SMC_LAT_NUM_BUCKETS))
+		return -EINVAL;
+
+	hist = &smc_lat_stats[cpu_idx].hist[entry];
+	*smc_fid = hist->smc_fid;
+	*count = hist->count;
+	*bucket_count = hist->buckets[bucket];
+
+	return 0;
+}
+
+/*
+ * Handle PMF_SMC_GET_SMC_LATENCY_64, called by pmf_smc_handler().
+ * x1 --> mpidr of the CPU.
+ * x2 --> histogram entry, from 0 to PLAT_PMF_SMC_LAT_NUM_FIDS.
+ * x3 --> bucket, from 0 to PMF_SMC_LAT_NUM_BUCKETS - 1.
+ */
+uintptr_t pmf_smc_latency_smc_handler(u_register_t x1, u_register_t x2,
+				      u_register_t x3, void *handle)
+{
+	int rc;
+	uint32_t smc_fid = 0U, bucket_count = 0U;
+	uint64_t count = 0ULL;
+
+	rc = pmf_smc_latency_get(x1, (unsigned int)x2, (unsigned int)x3,
+				 &smc_fid, &count, &bucket_count);
+
+	/*
+	 * Return error code, function ID, total number of calls and number of
+	 * calls in the bucket to the caller.
+	 * x0 --> error code.
+	 * x1 --> SMC function ID.
+	 * x2 --> total number of calls.
+	 * x3 --> number of calls in the bucket.
+	 */
+	SMC_RET4(handle, rc, smc_fid, count, bucket_count);
+}
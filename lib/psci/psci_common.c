@@ -16,6 +16,7 @@
 #include <lib/utils.h>
 #include <plat/common/platform.h>
 
+#include "psci_pd_state.h"
 #include "psci_private.h"
 
 /*
@@ -58,11 +59,36 @@ __section("tzfw_coherent_mem")
 #endif
 ;
 
+#if PSCI_ATOMIC_COORDINATION
+/*
+ * The state word of each non-CPU power domain, see psci_pd_state.h. Each state
+ * word has a cache line of its own as it is updated by all the CPUs in the
+ * power domain.
+ */
+typedef struct psci_pd_state {
+	unsigned int word;
+} __aligned(CACHE_WRITEBACK_GRANULE) psci_pd_state_t;
+
+static psci_pd_state_t psci_pd_states[PSCI_NUM_NON_CPU_PWR_DOMAINS];
+
+CASSERT(PLATFORM_CORE_COUNT < PD_STATE_COUNT_MASK,
+	assert_psci_pd_state_count_fits);
+#else
 /* Lock for PSCI state coordination */
 DEFINE_PSCI_LOCK(psci_locks[PSCI_NUM_NON_CPU_PWR_DOMAINS]);
+#endif
 
 cpu_pd_node_t psci_cpu_pd_nodes[PLATFORM_CORE_COUNT];
 
+/*******************************************************************************
+ * Per-CPU table of the indices in 'psci_non_cpu_pd_nodes' of the ancestors of
+ * each CPU power domain, one entry for each level from PSCI_CPU_PWR_LVL + 1 to
+ * PLAT_MAX_PWR_LVL. The power domain tree is static once populated, so this is
+ * filled in once by psci_setup() and avoids walking the tree through the
+ * 'parent_node' links on every PSCI call.
+ ******************************************************************************/
+static unsigned int psci_cpu_parent_nodes[PLATFORM_CORE_COUNT][PLAT_MAX_PWR_LVL];
+
 /*******************************************************************************
  * Pointer to functions exported by the platform to complete power mgmt. ops
  ******************************************************************************/
@@ -321,6 +347,7 @@ void psci_get_target_local_pwr_states(unsigned int end_pwrlvl,
 		target_state->pwr_domain_state[lvl] = PSCI_LOCAL_STATE_RUN;
 }
 
+#if !PSCI_ATOMIC_COORDINATION
 /******************************************************************************
  * Helper function to set the target local power state that each power domain
  * from the current cpu power domain to its ancestor at the 'end_pwrlvl' will
@@ -349,6 +376,7 @@ static void psci_set_target_local_pwr_states(unsigned int end_pwrlvl,
 		parent_idx = psci_non_cpu_pd_nodes[parent_idx].parent_node;
 	}
 }
+#endif
 
 
 /*******************************************************************************
@@ -358,15 +386,51 @@ void psci_get_parent_pwr_domain_nodes(unsigned int cpu_idx,
 				      unsigned int end_lvl,
 				      unsigned int *node_index)
 {
-	unsigned int parent_node = psci_cpu_pd_nodes[cpu_idx].parent_node;
+	const unsigned int *parent_node;
 	unsigned int i;
 	unsigned int *node = node_index;
 
+	assert(cpu_idx < psci_plat_core_count);
+	assert(end_lvl <= PLAT_MAX_PWR_LVL);
+
+	parent_node = psci_cpu_parent_nodes[cpu_idx];
+
 	for (i = PSCI_CPU_PWR_LVL + 1U; i <= end_lvl; i++) {
-		*node = parent_node;
+		*node = *parent_node;
 		node++;
-		parent_node = psci_non_cpu_pd_nodes[parent_node].parent_node;
+		parent_node++;
+	}
+}
+
+/******************************************************************************
+ * This function walks the power domain tree once for each CPU and records the
+ * indices of its ancestor power domain nodes in 'psci_cpu_parent_nodes'. It
+ * must be called after the power domain tree has been populated.
+ *****************************************************************************/
+void psci_init_parent_pwr_domain_nodes(void)
+{
+	unsigned int cpu_idx, lvl, parent_node;
+
+	for (cpu_idx = 0U; cpu_idx < psci_plat_core_count; cpu_idx++) {
+		parent_node = psci_cpu_pd_nodes[cpu_idx].parent_node;
+
+		for (lvl = PSCI_CPU_PWR_LVL + 1U; lvl <= PLAT_MAX_PWR_LVL;
+		     lvl++) {
+			assert(parent_node < PSCI_NUM_NON_CPU_PWR_DOMAINS);
+			assert(psci_non_cpu_pd_nodes[parent_node].level == lvl);
+
+			psci_cpu_parent_nodes[cpu_idx][lvl - 1U] = parent_node;
+			parent_node =
+				psci_non_cpu_pd_nodes[parent_node].parent_node;
+		}
 	}
+
+	/*
+	 * The table is read by secondary CPUs during warm boot, so make sure
+	 * it is visible to them.
+	 */
+	psci_flush_dcache_range((uintptr_t)psci_cpu_parent_nodes,
+				sizeof(psci_cpu_parent_nodes));
 }
 
 /******************************************************************************
@@ -396,6 +460,117 @@ void psci_set_pwr_domains_to_run(unsigned int end_pwrlvl)
 	psci_flush_cpu_data(psci_svc_cpu_data);
 }
 
+#if PSCI_ATOMIC_COORDINATION
+/******************************************************************************
+ * This function initializes the power domain state words. A power domain at
+ * the lowest non-CPU level counts the CPUs in it which requested RUN for it,
+ * and a power domain at a higher level counts its child power domains which
+ * are counted as running themselves. It must be called once the requested
+ * states of the boot CPU have been set to RUN.
+ *****************************************************************************/
+void __init psci_init_pwr_domain_states(void)
+{
+	unsigned int cpu_idx, node_idx, lvl, parent_idx;
+
+	for (cpu_idx = 0U; cpu_idx < psci_plat_core_count; cpu_idx++) {
+		if (is_local_state_run(
+		    psci_req_local_pwr_states[PSCI_CPU_PWR_LVL][cpu_idx]) != 0) {
+			parent_idx = psci_cpu_parent_nodes[cpu_idx][0];
+			psci_pd_states[parent_idx].word++;
+		}
+	}
+
+	for (lvl = PSCI_CPU_PWR_LVL + 1U; lvl < PLAT_MAX_PWR_LVL; lvl++) {
+		for (node_idx = 0U; node_idx < PSCI_NUM_NON_CPU_PWR_DOMAINS;
+		     node_idx++) {
+			if ((psci_non_cpu_pd_nodes[node_idx].level != lvl) ||
+			    (psci_pd_states[node_idx].word == 0U)) {
+				continue;
+			}
+
+			parent_idx = psci_non_cpu_pd_nodes[node_idx].parent_node;
+			psci_pd_states[parent_idx].word++;
+		}
+	}
+}
+
+/******************************************************************************
+ * This function is passed the local power states requested for each power
+ * domain (state_info) between the current CPU domain and its ancestors until
+ * the target power level (end_pwrlvl). It updates the array of requested power
+ * states with this information.
+ *
+ * Then, starting from the lowest non-CPU level, the CPU removes itself from
+ * the count of the power domain at that level if it requested a low power
+ * state for it. The last CPU to do so takes ownership of the power domain in
+ * the same atomic update and lets the platform coordinate amongst the states
+ * requested by all the CPUs in it. If the target state is a low power state,
+ * the power domain in turn leaves the count of its parent and the same is
+ * done at the next level. The power domains at all the other levels stay
+ * running.
+ *
+ * The 'state_info' is updated with the target state for each level between the
+ * CPU and the 'end_pwrlvl' and returned to the caller. Only the target states
+ * of the power domains owned by the CPU are recorded in the power domain
+ * nodes, and the ownership is given up by psci_release_pwr_domain_locks().
+ *
+ * This function will only be invoked with data cache enabled and while
+ * powering down a core.
+ *****************************************************************************/
+void psci_do_state_coordination(unsigned int end_pwrlvl,
+				psci_power_state_t *state_info)
+{
+	unsigned int lvl, parent_idx, cpu_idx = plat_my_core_pos();
+	plat_local_state_t target_state, *req_states;
+
+	assert(end_pwrlvl <= PLAT_MAX_PWR_LVL);
+
+	/*
+	 * The requested states must be visible to the CPUs coordinating the
+	 * power domains before this CPU stops being counted for them.
+	 */
+	for (lvl = PSCI_CPU_PWR_LVL + 1U; lvl <= end_pwrlvl; lvl++) {
+		psci_set_req_local_pwr_state(lvl, cpu_idx,
+					     state_info->pwr_domain_state[lvl]);
+	}
+
+	for (lvl = PSCI_CPU_PWR_LVL + 1U; lvl <= end_pwrlvl; lvl++) {
+		if (is_local_state_run(state_info->pwr_domain_state[lvl]) != 0) {
+			break;
+		}
+
+		parent_idx = psci_cpu_parent_nodes[cpu_idx][lvl - 1U];
+		if (!psci_pd_state_leave(&psci_pd_states[parent_idx].word,
+					 cpu_idx)) {
+			break;
+		}
+
+		/*
+		 * Let the platform coordinate amongst the requested states at
+		 * this power level and return the target local power state.
+		 */
+		req_states = psci_get_req_local_pwr_states(lvl,
+				psci_non_cpu_pd_nodes[parent_idx].cpu_start_idx);
+		target_state = plat_get_target_pwr_state(lvl, req_states,
+				psci_non_cpu_pd_nodes[parent_idx].ncpus);
+
+		state_info->pwr_domain_state[lvl] = target_state;
+		set_non_cpu_pd_node_local_state(parent_idx, target_state);
+
+		/* A running power domain is still counted by its parent */
+		if (is_local_state_run(target_state) != 0) {
+			break;
+		}
+	}
+
+	for (; lvl <= end_pwrlvl; lvl++) {
+		state_info->pwr_domain_state[lvl] = PSCI_LOCAL_STATE_RUN;
+	}
+
+	psci_set_cpu_local_state(state_info->pwr_domain_state[PSCI_CPU_PWR_LVL]);
+	psci_flush_cpu_data(psci_svc_cpu_data.local_state);
+}
+#else
 /******************************************************************************
  * This function is passed the local power states requested for each power
  * domain (state_info) between the current CPU domain and its ancestors until
@@ -473,6 +648,7 @@ void psci_do_state_coordination(unsigned int end_pwrlvl,
 	/* Update the target state in the power domain nodes */
 	psci_set_target_local_pwr_states(end_pwrlvl, state_info);
 }
+#endif /* PSCI_ATOMIC_COORDINATION */
 
 /******************************************************************************
  * This function validates a suspend request by making sure that if a standby
@@ -570,6 +746,62 @@ unsigned int psci_find_target_suspend_lvl(const psci_power_state_t *state_info)
 	return PSCI_INVALID_PWR_LVL;
 }
 
+#if PSCI_ATOMIC_COORDINATION
+/******************************************************************************
+ * This function is passed the highest level in the topology tree that the
+ * operation should be applied to and a list of node indexes. It is the
+ * counterpart of psci_acquire_pwr_domain_locks() with PSCI_ATOMIC_COORDINATION.
+ *
+ * A CPU on its way down is still counted for every power domain, and only
+ * takes ownership of those it turns out to be the last CPU of during state
+ * coordination, so nothing needs to be done here. A CPU waking up adds itself
+ * back to the count of the lowest non-CPU power domain if it had requested a
+ * low power state for it. If it is the first CPU to wake up in the power
+ * domain, it takes ownership of it and, if the power domain had left its
+ * parent, the power domain is added back to the count of its parent in turn.
+ ******************************************************************************/
+void psci_acquire_pwr_domain_locks(unsigned int end_pwrlvl,
+				   const unsigned int *parent_nodes)
+{
+	unsigned int level, parent_idx, cpu_idx = plat_my_core_pos();
+
+	for (level = PSCI_CPU_PWR_LVL + 1U; level <= end_pwrlvl; level++) {
+		if (is_local_state_run(
+		    psci_req_local_pwr_states[level - 1U][cpu_idx]) != 0) {
+			break;
+		}
+
+		parent_idx = parent_nodes[level - 1U];
+		if (!psci_pd_state_enter(&psci_pd_states[parent_idx].word,
+					 cpu_idx)) {
+			break;
+		}
+
+		if (is_local_state_run(
+		    get_non_cpu_pd_node_local_state(parent_idx)) != 0) {
+			break;
+		}
+	}
+}
+
+/******************************************************************************
+ * This function is passed the highest level in the topology tree that the
+ * operation should be applied to and a list of node indexes. It gives up the
+ * ownership of the power domains held by the calling CPU in order of
+ * decreasing power domain level in the range specified.
+ ******************************************************************************/
+void psci_release_pwr_domain_locks(unsigned int end_pwrlvl,
+				   const unsigned int *parent_nodes)
+{
+	unsigned int level, cpu_idx = plat_my_core_pos();
+
+	for (level = end_pwrlvl; level >= PSCI_CPU_PWR_LVL + 1U; level--) {
+		psci_pd_state_release(
+			&psci_pd_states[parent_nodes[level - 1U]].word,
+			cpu_idx);
+	}
+}
+#else
 /*******************************************************************************
  * This function is passed the highest level in the topology tree that the
  * operation should be applied to and a list of node indexes. It picks up locks
@@ -606,6 +838,7 @@ void psci_release_pwr_domain_locks(unsigned int end_pwrlvl,
 		psci_lock_release(&psci_non_cpu_pd_nodes[parent_idx]);
 	}
 }
+#endif /* PSCI_ATOMIC_COORDINATION */
 
 /*******************************************************************************
  * Simple routine to determine whether a mpidr is valid or not.
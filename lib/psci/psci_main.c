@@ -367,6 +367,25 @@ int psci_features(unsigned int psci_fid)
 	return PSCI_E_SUCCESS;
 }
 
+/*******************************************************************************
+ * PSCI handler for servicing PSCI_CPU_SUSPEND_AARCH64 SMCs only. It does the
+ * same checks as psci_smc_handler() for this function ID, without dispatching
+ * on the function ID.
+ ******************************************************************************/
+u_register_t psci_cpu_suspend_smc_handler(u_register_t x1,
+			  u_register_t x2,
+			  u_register_t x3,
+			  u_register_t flags)
+{
+	if (is_caller_secure(flags))
+		return (u_register_t)SMC_UNK;
+
+	if ((psci_caps & define_psci_cap(PSCI_CPU_SUSPEND_AARCH64)) == 0U)
+		return (u_register_t)SMC_UNK;
+
+	return (u_register_t)psci_cpu_suspend((unsigned int)x1, x2, x3);
+}
+
 /*******************************************************************************
  * PSCI top level handler for servicing SMCs.
  ******************************************************************************/
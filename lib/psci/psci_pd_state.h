@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2020, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef PSCI_PD_STATE_H
+#define PSCI_PD_STATE_H
+
+#include <assert.h>
+#include <stdbool.h>
+
+#include <lib/utils_def.h>
+
+/*******************************************************************************
+ * With PSCI_ATOMIC_COORDINATION, each non-CPU power domain has a state word
+ * instead of a lock. The low half of the word counts the CPUs in the power
+ * domain which currently keep it running, i.e. whose requested local power
+ * state for it is RUN. The high half holds the index + 1 of the CPU which owns
+ * the power domain while it transitions, i.e. the last CPU powering it down or
+ * the first CPU powering it back up, or 0 if there is no such CPU.
+ *
+ * Only these transitions require exclusive access to a power domain. A CPU
+ * which leaves other CPUs running in a power domain, or which wakes up in a
+ * power domain that is already running, only updates the count.
+ *
+ * The transitions only depend on the compiler's __atomic builtins so that they
+ * can also be exercised on the host.
+ ******************************************************************************/
+#define PD_STATE_COUNT_MASK	U(0xffff)
+#define PD_STATE_OWNER_SHIFT	U(16)
+
+/*******************************************************************************
+ * Remove the calling CPU from the count of CPUs keeping the power domain
+ * running. Returns true if it was the last one, in which case the calling CPU
+ * has also become the owner of the power domain in the same atomic update, so
+ * that no other CPU can wake up in it before the calling CPU is done with it.
+ ******************************************************************************/
+static inline bool psci_pd_state_leave(unsigned int *word, unsigned int cpu_idx)
+{
+	unsigned int old_word = __atomic_load_n(word, __ATOMIC_RELAXED);
+	unsigned int new_word;
+
+	do {
+		assert((old_word & PD_STATE_COUNT_MASK) != 0U);
+
+		new_word = old_word - 1U;
+		if ((new_word & PD_STATE_COUNT_MASK) == 0U) {
+			/*
+			 * A CPU owning the power domain would still be
+			 * counted, so there can't be one here.
+			 */
+			assert(new_word == 0U);
+			new_word = (cpu_idx + 1U) << PD_STATE_OWNER_SHIFT;
+		}
+	} while (!__atomic_compare_exchange_n(word, &old_word, new_word, true,
+					      __ATOMIC_ACQ_REL,
+					      __ATOMIC_RELAXED));
+
+	return (new_word & PD_STATE_COUNT_MASK) == 0U;
+}
+
+/*******************************************************************************
+ * Add the calling CPU to the count of CPUs keeping the power domain running,
+ * after waiting for the CPU which owns the power domain, if any, to complete
+ * its transition. Returns true if no other CPU was keeping the power domain
+ * running, in which case the calling CPU has become its owner.
+ ******************************************************************************/
+static inline bool psci_pd_state_enter(unsigned int *word, unsigned int cpu_idx)
+{
+	unsigned int old_word = __atomic_load_n(word, __ATOMIC_RELAXED);
+	unsigned int new_word;
+
+	do {
+		while ((old_word & ~PD_STATE_COUNT_MASK) != 0U) {
+			old_word = __atomic_load_n(word, __ATOMIC_RELAXED);
+		}
+
+		new_word = old_word + 1U;
+		if (old_word == 0U) {
+			new_word |= (cpu_idx + 1U) << PD_STATE_OWNER_SHIFT;
+		}
+	} while (!__atomic_compare_exchange_n(word, &old_word, new_word, true,
+					      __ATOMIC_ACQ_REL,
+					      __ATOMIC_RELAXED));
+
+	return old_word == 0U;
+}
+
+/*******************************************************************************
+ * Give up the ownership of the power domain if the calling CPU holds it.
+ ******************************************************************************/
+static inline void psci_pd_state_release(unsigned int *word,
+					 unsigned int cpu_idx)
+{
+	if ((__atomic_load_n(word, __ATOMIC_RELAXED) >> PD_STATE_OWNER_SHIFT) ==
+	    (cpu_idx + 1U)) {
+		(void)__atomic_fetch_and(word, PD_STATE_COUNT_MASK,
+					 __ATOMIC_RELEASE);
+	}
+}
+
+#endif /* PSCI_PD_STATE_H */
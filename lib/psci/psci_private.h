@@ -274,6 +274,10 @@ int psci_validate_entry_point(entry_point_info_t *ep,
 void psci_get_parent_pwr_domain_nodes(unsigned int cpu_idx,
 				      unsigned int end_lvl,
 				      unsigned int *node_index);
+void psci_init_parent_pwr_domain_nodes(void);
+#if PSCI_ATOMIC_COORDINATION
+void psci_init_pwr_domain_states(void);
+#endif
 void psci_do_state_coordination(unsigned int end_pwrlvl,
 				psci_power_state_t *state_info);
 void psci_acquire_pwr_domain_locks(unsigned int end_pwrlvl,
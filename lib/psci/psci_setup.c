@@ -204,6 +204,9 @@ int __init psci_setup(const psci_lib_args_t *lib_args)
 	/* Populate the power domain arrays using the platform topology map */
 	psci_plat_core_count = populate_power_domain_tree(topology_tree);
 
+	/* Cache the ancestor power domain nodes of each CPU */
+	psci_init_parent_pwr_domain_nodes();
+
 	/* Update the CPU limits for each node in psci_non_cpu_pd_nodes */
 	psci_update_pwrlvl_limits();
 
@@ -219,6 +222,11 @@ int __init psci_setup(const psci_lib_args_t *lib_args)
 	 */
 	psci_set_pwr_domains_to_run(PLAT_MAX_PWR_LVL);
 
+#if PSCI_ATOMIC_COORDINATION
+	/* Account for this CPU in the power domain state words */
+	psci_init_pwr_domain_states();
+#endif
+
 	(void) plat_setup_psci_ops((uintptr_t)lib_args->mailbox_ep,
 				   &psci_plat_pm_ops);
 	assert(psci_plat_pm_ops != NULL);
@@ -31,13 +31,57 @@ static int last_cpu_in_non_cpu_pd[PSCI_NUM_NON_CPU_PWR_DOMAINS] = {
 		[0 ... PSCI_NUM_NON_CPU_PWR_DOMAINS - 1] = -1};
 
 /*
- * Following are used to store PSCI STAT values for
- * CPU and non CPU power domains.
+ * Following is used to store PSCI STAT values for each CPU. Besides the stats
+ * of its own power domain, each CPU accumulates the stats of the power ups of
+ * its ancestor non CPU power domains which it has accounted, one entry per
+ * level above the CPU level. The stats of a non CPU power domain are the sum of
+ * the entries of all the CPUs in that power domain, which is only computed
+ * when they are queried.
+ *
+ * Each CPU only updates its own stats, so no locks are needed, and the stats
+ * of each CPU have cache lines of their own to avoid false sharing.
+ */
+typedef struct psci_cpu_stat {
+	psci_stat_t cpu[PLAT_MAX_PWR_LVL_STATES];
+	psci_stat_t non_cpu[PLAT_MAX_PWR_LVL][PLAT_MAX_PWR_LVL_STATES];
+} __aligned(CACHE_WRITEBACK_GRANULE) psci_cpu_stat_t;
+
+static psci_cpu_stat_t psci_cpu_stat[PLATFORM_CORE_COUNT];
+
+/* Index in the 'non_cpu' stats of a CPU of the non CPU level 'lvl' */
+#define NON_CPU_STAT_LVL_IDX(lvl)	((lvl) - PSCI_CPU_PWR_LVL - 1U)
+
+/*
+ * Record that 'cpu_idx' is the last CPU powering down a non CPU power domain.
  */
-static psci_stat_t psci_cpu_stat[PLATFORM_CORE_COUNT]
-				[PLAT_MAX_PWR_LVL_STATES];
-static psci_stat_t psci_non_cpu_stat[PSCI_NUM_NON_CPU_PWR_DOMAINS]
-				[PLAT_MAX_PWR_LVL_STATES];
+static void psci_stat_set_last_cpu(unsigned int parent_idx, int cpu_idx)
+{
+#if PSCI_ATOMIC_COORDINATION
+	__atomic_store_n(&last_cpu_in_non_cpu_pd[parent_idx], cpu_idx,
+			 __ATOMIC_RELEASE);
+#else
+	last_cpu_in_non_cpu_pd[parent_idx] = cpu_idx;
+#endif
+}
+
+/*
+ * Return the last CPU which powered down a non CPU power domain and reset it,
+ * so that the power up of the power domain is only accounted once. Without
+ * locks to serialise the CPUs powering up the power domain, this needs to be
+ * an atomic exchange.
+ */
+static int psci_stat_claim_last_cpu(unsigned int parent_idx)
+{
+#if PSCI_ATOMIC_COORDINATION
+	return __atomic_exchange_n(&last_cpu_in_non_cpu_pd[parent_idx], -1,
+				   __ATOMIC_ACQ_REL);
+#else
+	int last_cpu_idx = last_cpu_in_non_cpu_pd[parent_idx];
+
+	last_cpu_in_non_cpu_pd[parent_idx] = -1;
+	return last_cpu_idx;
+#endif
+}
 
 /*
  * This functions returns the index into the `psci_stat_t` array given the
@@ -94,7 +138,7 @@ void psci_stats_update_pwr_down(unsigned int end_pwrlvl,
 		 * The power domain is entering a low power state, so this is
 		 * the last CPU for this power domain
 		 */
-		last_cpu_in_non_cpu_pd[parent_idx] = cpu_idx;
+		psci_stat_set_last_cpu(parent_idx, cpu_idx);
 
 		parent_idx = psci_non_cpu_pd_nodes[parent_idx].parent_node;
 	}
@@ -103,17 +147,19 @@ void psci_stats_update_pwr_down(unsigned int end_pwrlvl,
 
 /*******************************************************************************
  * This function updates the PSCI STATS(residency time and count) for CPU
- * and NON-CPU power domains.
- * It is called with caches enabled and locks acquired(for NON-CPU domain)
+ * and NON-CPU power domains. The stats of the NON-CPU power domains that this
+ * CPU powers up are accounted in the stats of this CPU.
+ * It is called with caches enabled.
  ******************************************************************************/
 void psci_stats_update_pwr_up(unsigned int end_pwrlvl,
 			const psci_power_state_t *state_info)
 {
 	unsigned int lvl, parent_idx;
 	int cpu_idx = (int) plat_my_core_pos();
-	int stat_idx;
+	int stat_idx, last_cpu_idx;
 	plat_local_state_t local_state;
 	u_register_t residency;
+	psci_cpu_stat_t *stat = &psci_cpu_stat[cpu_idx];
 
 	assert(end_pwrlvl <= PLAT_MAX_PWR_LVL);
 	assert(state_info != NULL);
@@ -127,17 +173,14 @@ void psci_stats_update_pwr_up(unsigned int end_pwrlvl,
 	    state_info, cpu_idx);
 
 	/* Update CPU stats. */
-	psci_cpu_stat[cpu_idx][stat_idx].residency += residency;
-	psci_cpu_stat[cpu_idx][stat_idx].count++;
+	stat->cpu[stat_idx].residency += residency;
+	stat->cpu[stat_idx].count++;
 
 	/*
 	 * Check what power domains above CPU were off
 	 * prior to this CPU powering on.
 	 */
 	parent_idx = psci_cpu_pd_nodes[cpu_idx].parent_node;
-	/* Return early if this is the first power up. */
-	if (last_cpu_in_non_cpu_pd[parent_idx] == -1)
-		return;
 
 	for (lvl = PSCI_CPU_PWR_LVL + 1U; lvl <= end_pwrlvl; lvl++) {
 		local_state = state_info->pwr_domain_state[lvl];
@@ -146,21 +189,25 @@ void psci_stats_update_pwr_up(unsigned int end_pwrlvl,
 			break;
 		}
 
-		assert(last_cpu_in_non_cpu_pd[parent_idx] != -1);
+		/*
+		 * Break early if this is the first power up, or if another CPU
+		 * has already accounted this power up.
+		 */
+		last_cpu_idx = psci_stat_claim_last_cpu(parent_idx);
+		if (last_cpu_idx == -1)
+			break;
 
 		/* Call into platform interface to calculate residency. */
 		residency = plat_psci_stat_get_residency(lvl, state_info,
-					last_cpu_in_non_cpu_pd[parent_idx]);
-
-		/* Initialize back to reset value */
-		last_cpu_in_non_cpu_pd[parent_idx] = -1;
+					last_cpu_idx);
 
 		/* Get the index into the stats array */
 		stat_idx = get_stat_idx(local_state, lvl);
 
 		/* Update non cpu stats */
-		psci_non_cpu_stat[parent_idx][stat_idx].residency += residency;
-		psci_non_cpu_stat[parent_idx][stat_idx].count++;
+		stat->non_cpu[NON_CPU_STAT_LVL_IDX(lvl)][stat_idx].residency +=
+			residency;
+		stat->non_cpu[NON_CPU_STAT_LVL_IDX(lvl)][stat_idx].count++;
 
 		parent_idx = psci_non_cpu_pd_nodes[parent_idx].parent_node;
 	}
@@ -176,8 +223,9 @@ static int psci_get_stat(u_register_t target_cpu, unsigned int power_state,
 			 psci_stat_t *psci_stat)
 {
 	int rc;
-	unsigned int pwrlvl, lvl, parent_idx, target_idx;
+	unsigned int pwrlvl, lvl, parent_idx, target_idx, cpu_idx, end_idx;
 	int stat_idx;
+	const psci_stat_t *cpu_stat;
 	psci_power_state_t state_info = { {PSCI_LOCAL_STATE_RUN} };
 	plat_local_state_t local_state;
 
@@ -213,11 +261,24 @@ static int psci_get_stat(u_register_t target_cpu, unsigned int power_state,
 		for (lvl = PSCI_CPU_PWR_LVL + 1U; lvl < pwrlvl; lvl++)
 			parent_idx = SPECULATION_SAFE_VALUE(psci_non_cpu_pd_nodes[parent_idx].parent_node);
 
-		/* Get the non cpu power domain stats */
-		*psci_stat = psci_non_cpu_stat[parent_idx][stat_idx];
+		/*
+		 * Aggregate the non cpu power domain stats accounted by the
+		 * cpus in the power domain.
+		 */
+		psci_stat->residency = 0U;
+		psci_stat->count = 0U;
+
+		cpu_idx = psci_non_cpu_pd_nodes[parent_idx].cpu_start_idx;
+		end_idx = cpu_idx + psci_non_cpu_pd_nodes[parent_idx].ncpus;
+		for (; cpu_idx < end_idx; cpu_idx++) {
+			cpu_stat = &psci_cpu_stat[cpu_idx].non_cpu
+					[NON_CPU_STAT_LVL_IDX(pwrlvl)][stat_idx];
+			psci_stat->residency += cpu_stat->residency;
+			psci_stat->count += cpu_stat->count;
+		}
 	} else {
 		/* Get the cpu power domain stats */
-		*psci_stat = psci_cpu_stat[target_idx][stat_idx];
+		*psci_stat = psci_cpu_stat[target_idx].cpu[stat_idx];
 	}
 
 	return PSCI_E_SUCCESS;
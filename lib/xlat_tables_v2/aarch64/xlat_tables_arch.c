@@ -157,14 +157,12 @@ uint64_t xlat_arch_regime_get_xn_desc(int xlat_regime)
 	}
 }
 
-void xlat_arch_tlbi_va(uintptr_t va, int xlat_regime)
+/*
+ * Issue the TLB invalidation of 'va' for the given translation regime, without
+ * any barrier.
+ */
+static void xlat_arch_tlbi_va_nobarrier(uintptr_t va, int xlat_regime)
 {
-	/*
-	 * Ensure the translation table write has drained into memory before
-	 * invalidating the TLB entry.
-	 */
-	dsbishst();
-
 	/*
 	 * This function only supports invalidation of TLB entries for the EL3
 	 * and EL1&0 translation regimes.
@@ -185,6 +183,119 @@ void xlat_arch_tlbi_va(uintptr_t va, int xlat_regime)
 	}
 }
 
+void xlat_arch_tlbi_va(uintptr_t va, int xlat_regime)
+{
+	/*
+	 * Ensure the translation table write has drained into memory before
+	 * invalidating the TLB entry.
+	 */
+	dsbishst();
+
+	xlat_arch_tlbi_va_nobarrier(va, xlat_regime);
+}
+
+/* Invalidate all the TLB entries of the given translation regime. */
+static void xlat_arch_tlbi_all(int xlat_regime)
+{
+	if (xlat_regime == EL1_EL0_REGIME) {
+		assert(xlat_arch_current_el() >= 1U);
+		tlbivmalle1is();
+	} else if (xlat_regime == EL2_REGIME) {
+		assert(xlat_arch_current_el() >= 2U);
+		tlbialle2is();
+	} else {
+		assert(xlat_regime == EL3_REGIME);
+		assert(xlat_arch_current_el() >= 3U);
+		tlbialle3is();
+	}
+}
+
+/*
+ * Invalidate the TLB entries of (num + 1) * 2^(5 * scale + 1) pages starting
+ * from 'va' with a single ARMv8.4-TLBI range instruction.
+ */
+static void xlat_arch_tlbi_va_range_op(uintptr_t va, unsigned long long num,
+				       unsigned int scale, int xlat_regime)
+{
+	uint64_t op = TLBI_RANGE_ADDR(va, num, scale);
+
+	if (xlat_regime == EL1_EL0_REGIME) {
+		assert(xlat_arch_current_el() >= 1U);
+		tlbirvaae1is(op);
+	} else if (xlat_regime == EL2_REGIME) {
+		assert(xlat_arch_current_el() >= 2U);
+		tlbirvae2is(op);
+	} else {
+		assert(xlat_regime == EL3_REGIME);
+		assert(xlat_arch_current_el() >= 3U);
+		tlbirvae3is(op);
+	}
+}
+
+/* The range operands are only built for the 4KB translation granule. */
+CASSERT(PAGE_SIZE == PAGE_SIZE_4KB, assert_tlbi_range_granule);
+CASSERT(PLAT_XLAT_TLBI_RANGE_MAX_PAGES < TLBI_RANGE_MAX_PAGES,
+	assert_tlbi_range_max_pages);
+
+void xlat_arch_tlbi_va_range(uintptr_t va, size_t size, int xlat_regime)
+{
+	unsigned long long pages = (unsigned long long)size >> PAGE_SIZE_SHIFT;
+	unsigned long long num;
+	unsigned int scale = 0U;
+
+	assert(IS_PAGE_ALIGNED(va) && ((size % PAGE_SIZE) == 0U));
+
+	/*
+	 * Ensure the translation table writes have drained into memory before
+	 * invalidating the TLB entries.
+	 */
+	dsbishst();
+
+	/*
+	 * Past a certain size it is cheaper to drop all the TLB entries of the
+	 * translation regime than to invalidate them one by one.
+	 */
+	if (pages > PLAT_XLAT_TLBI_RANGE_MAX_PAGES) {
+		xlat_arch_tlbi_all(xlat_regime);
+		return;
+	}
+
+	if (!is_armv8_4_tlbi_range_present()) {
+		for (; pages > 0ULL; pages--) {
+			xlat_arch_tlbi_va_nobarrier(va, xlat_regime);
+			va += PAGE_SIZE;
+		}
+		return;
+	}
+
+	/*
+	 * Range operations cover an even number of pages, so an odd page is
+	 * invalidated on its own. The rest is split in at most one operation
+	 * per SCALE value, from the smallest to the biggest chunks.
+	 */
+	while (pages > 0ULL) {
+		if ((pages % 2ULL) != 0ULL) {
+			xlat_arch_tlbi_va_nobarrier(va, xlat_regime);
+			va += PAGE_SIZE;
+			pages--;
+			continue;
+		}
+
+		assert(scale <= TLBI_RANGE_SCALE_MASK);
+
+		num = (pages >> ((5U * scale) + 1U)) & TLBI_RANGE_NUM_MASK;
+		if (num != 0ULL) {
+			xlat_arch_tlbi_va_range_op(va, num - 1ULL, scale,
+						   xlat_regime);
+			va += (uintptr_t)(TLBI_RANGE_PAGES(num - 1ULL, scale) <<
+					  PAGE_SIZE_SHIFT);
+			pages -= TLBI_RANGE_PAGES(num - 1ULL, scale);
+		}
+
+		scale++;
+	}
+}
+
 void xlat_arch_tlbi_va_sync(void)
 {
 	/*
@@ -14,6 +14,7 @@
 
 #include <arch_features.h>
 #include <arch_helpers.h>
+#include <common/bl_common.h>
 #include <common/debug.h>
 #include <lib/utils_def.h>
 #include <lib/xlat_tables/xlat_tables_defs.h>
@@ -91,10 +92,15 @@ static bool xlat_table_is_empty(const xlat_ctx_t *ctx, const uint64_t *table)
 
 #else /* PLAT_XLAT_TABLES_DYNAMIC */
 
-/* Returns a pointer to the first empty translation table. */
+/*
+ * Returns a pointer to the first empty translation table, or NULL if they have
+ * all been used. Splitting blocks at runtime can run out of tables, so this is
+ * not only checked by an assertion.
+ */
 static uint64_t *xlat_table_get_empty(xlat_ctx_t *ctx)
 {
-	assert(ctx->next_table < ctx->tables_num);
+	if (ctx->next_table >= ctx->tables_num)
+		return NULL;
 
 	return ctx->tables[ctx->next_table++];
 }
@@ -340,7 +346,8 @@ static action_t xlat_tables_unmap_region_action(const mmap_region_t *mm,
 }
 /*
  * Recursive function that writes to the translation tables and unmaps the
- * specified region.
+ * specified region. The caller is responsible for invalidating the TLB entries
+ * of the whole region afterwards with xlat_arch_tlbi_va_range().
  */
 static void xlat_tables_unmap_region(xlat_ctx_t *ctx, mmap_region_t *mm,
 				     const uintptr_t table_base_va,
@@ -377,7 +384,6 @@ static void xlat_tables_unmap_region(xlat_ctx_t *ctx, mmap_region_t *mm,
 		if (action == ACTION_WRITE_BLOCK_ENTRY) {
 
 			table_base[table_idx] = INVALID_DESC;
-			xlat_arch_tlbi_va(table_idx_va, ctx->xlat_regime);
 
 		} else if (action == ACTION_RECURSE_INTO_TABLE) {
 
@@ -394,11 +400,8 @@ static void xlat_tables_unmap_region(xlat_ctx_t *ctx, mmap_region_t *mm,
 			/*
 			 * If the subtable is now empty, remove its reference.
 			 */
-			if (xlat_table_is_empty(ctx, subtable)) {
+			if (xlat_table_is_empty(ctx, subtable))
 				table_base[table_idx] = INVALID_DESC;
-				xlat_arch_tlbi_va(table_idx_va,
-						  ctx->xlat_regime);
-			}
 
 		} else {
 			assert(action == ACTION_NONE);
@@ -549,6 +552,38 @@ static action_t xlat_tables_map_region_action(const mmap_region_t *mm,
 	}
 }
 
+/*
+ * Returns true if the XLAT_CONT_ENTRIES entries of a table starting at index
+ * 'table_idx', which map 'table_idx_va' at the given level, can all be written
+ * by the specified region with the Contiguous hint set. The region must map
+ * all of them to a suitably aligned physical address and none of them can be
+ * in use already.
+ */
+static bool xlat_tables_map_region_contig(const mmap_region_t *mm,
+					  const uint64_t *table_base,
+					  unsigned int table_entries,
+					  unsigned int table_idx,
+					  uintptr_t table_idx_va,
+					  unsigned long long table_idx_pa,
+					  unsigned int level)
+{
+	uintptr_t mm_end_va = mm->base_va + mm->size - 1U;
+
+	if ((level < XLAT_CONT_MIN_LEVEL) ||
+	    ((table_idx + XLAT_CONT_ENTRIES) > table_entries) ||
+	    (mm->base_va > table_idx_va) ||
+	    ((mm_end_va - table_idx_va) < XLAT_CONT_MASK(level)) ||
+	    ((table_idx_pa & XLAT_CONT_MASK(level)) != 0U))
+		return false;
+
+	for (unsigned int i = 0U; i < XLAT_CONT_ENTRIES; i++) {
+		if ((table_base[table_idx + i] & DESC_MASK) != INVALID_DESC)
+			return false;
+	}
+
+	return true;
+}
+
 /*
  * Recursive function that writes to the translation tables and maps the
  * specified region. On success, it returns the VA of the last byte that was
@@ -573,6 +608,9 @@ static uintptr_t xlat_tables_map_region(xlat_ctx_t *ctx, mmap_region_t *mm,
 
 	unsigned int table_idx;
 
+	/* Set the Contiguous hint in the current group of entries */
+	bool contig = false;
+
 	table_idx_va = xlat_tables_find_start_va(mm, table_base_va, level);
 	table_idx = xlat_tables_va_to_index(table_base_va, table_idx_va, level);
 
@@ -587,6 +625,17 @@ static uintptr_t xlat_tables_map_region(xlat_ctx_t *ctx, mmap_region_t *mm,
 
 		table_idx_pa = mm->base_pa + table_idx_va - mm->base_va;
 
+		/*
+		 * All the entries of a group covered by the Contiguous hint
+		 * get the same action, so the decision is made once for the
+		 * whole group.
+		 */
+		if ((table_idx % XLAT_CONT_ENTRIES) == 0U) {
+			contig = xlat_tables_map_region_contig(mm, table_base,
+					table_entries, table_idx, table_idx_va,
+					table_idx_pa, level);
+		}
+
 		action_t action = xlat_tables_map_region_action(mm,
 			(uint32_t)(desc & DESC_MASK), table_idx_pa,
 			table_idx_va, level);
@@ -596,6 +645,8 @@ static uintptr_t xlat_tables_map_region(xlat_ctx_t *ctx, mmap_region_t *mm,
 			table_base[table_idx] =
 				xlat_desc(ctx, (uint32_t)mm->attr, table_idx_pa,
 					  level);
+			if (contig)
+				table_base[table_idx] |= UPPER_ATTRS(CONT_HINT);
 
 		} else if (action == ACTION_CREATE_NEW_TABLE) {
 			uintptr_t end_va;
@@ -655,6 +706,316 @@ static uintptr_t xlat_tables_map_region(xlat_ctx_t *ctx, mmap_region_t *mm,
 	return table_idx_va - 1U;
 }
 
+#if PLAT_XLAT_TABLES_DYNAMIC
+/*
+ * Returns the number of regions of the mmap array that overlap the VA range
+ * [base_va, end_va]. If 'region' isn't NULL, the last of them is returned in
+ * it.
+ */
+static int mmap_count_overlapping_regions(const xlat_ctx_t *ctx,
+					  uintptr_t base_va, uintptr_t end_va,
+					  const mmap_region_t **region)
+{
+	int count = 0;
+
+	for (int i = 0; i < ctx->mmap_regions; i++) {
+		const mmap_region_t *mm = &ctx->mmap[i];
+
+		if ((mm->base_va <= end_va) &&
+		    ((mm->base_va + mm->size - 1U) >= base_va)) {
+			count++;
+			if (region != NULL)
+				*region = mm;
+		}
+	}
+
+	return count;
+}
+#endif /* PLAT_XLAT_TABLES_DYNAMIC */
+
+/*
+ * Replaces the valid descriptor pointed to by 'entry', which maps the VA 'va'
+ * at the given level, by 'desc' following the break-before-make sequence. If
+ * the old descriptor points to a table, the TLB entries of all the VAs it maps
+ * are invalidated, otherwise a single invalidation drops the block entry.
+ */
+static void xlat_tables_replace_entry(const xlat_ctx_t *ctx, uint64_t *entry,
+				      uintptr_t va, unsigned int level,
+				      uint64_t desc)
+{
+	bool was_table = (level < XLAT_TABLE_LEVEL_MAX) &&
+			 ((*entry & DESC_MASK) == TABLE_DESC);
+
+	*entry = INVALID_DESC;
+#if !(HW_ASSISTED_COHERENCY || WARMBOOT_ENABLE_DCACHE_EARLY)
+	xlat_clean_dcache_range((uintptr_t)entry, sizeof(uint64_t));
+#endif
+	if (was_table) {
+		xlat_arch_tlbi_va_range(va, XLAT_BLOCK_SIZE(level),
+					ctx->xlat_regime);
+	} else {
+		xlat_arch_tlbi_va(va, ctx->xlat_regime);
+	}
+	xlat_arch_tlbi_va_sync();
+
+	*entry = desc;
+#if !(HW_ASSISTED_COHERENCY || WARMBOOT_ENABLE_DCACHE_EARLY)
+	xlat_clean_dcache_range((uintptr_t)entry, sizeof(uint64_t));
+#endif
+	dsbish();
+}
+
+/* Returns true if [base_va, end_va] overlaps the 'size' bytes at 'addr'. */
+static bool xlat_va_overlaps(uintptr_t base_va, uintptr_t end_va,
+			     uintptr_t addr, size_t size)
+{
+	return (size != 0U) && (addr <= end_va) &&
+	       (base_va <= (addr + size - 1U));
+}
+
+bool xlat_range_in_use(const xlat_ctx_t *ctx, uintptr_t base_va,
+		       uintptr_t end_va)
+{
+	unsigned int el = xlat_arch_current_el();
+	int regime;
+	uintptr_t sp = (uintptr_t)&regime;
+
+	if (el == 3U) {
+		regime = EL3_REGIME;
+	} else if (el == 2U) {
+		regime = EL2_REGIME;
+	} else {
+		regime = EL1_EL0_REGIME;
+	}
+
+	if ((ctx->xlat_regime != regime) || !is_mmu_enabled_ctx(ctx))
+		return false;
+
+	/*
+	 * The stack of this CPU is only known from the current stack pointer,
+	 * so a whole stack is assumed on both sides of it.
+	 */
+	return xlat_va_overlaps(base_va, end_va, BL_CODE_BASE,
+				BL_CODE_END - BL_CODE_BASE) ||
+	       xlat_va_overlaps(base_va, end_va, sp - PLATFORM_STACK_SIZE,
+				2U * PLATFORM_STACK_SIZE) ||
+	       xlat_va_overlaps(base_va, end_va, (uintptr_t)ctx,
+				sizeof(*ctx)) ||
+	       xlat_va_overlaps(base_va, end_va, (uintptr_t)ctx->mmap,
+				(ctx->mmap_num + 1U) * sizeof(mmap_region_t)) ||
+	       xlat_va_overlaps(base_va, end_va, (uintptr_t)ctx->base_table,
+				ctx->base_table_entries * sizeof(uint64_t)) ||
+#if PLAT_XLAT_TABLES_DYNAMIC
+	       xlat_va_overlaps(base_va, end_va,
+				(uintptr_t)ctx->tables_mapped_regions,
+				ctx->tables_num * sizeof(int)) ||
+#endif
+	       xlat_va_overlaps(base_va, end_va, (uintptr_t)ctx->tables,
+				ctx->tables_num * XLAT_TABLE_SIZE);
+}
+
+int xlat_split_block(xlat_ctx_t *ctx, uint64_t *entry, uintptr_t block_va,
+		     unsigned int level)
+{
+	uint64_t desc = *entry;
+	unsigned long long block_pa = desc & TABLE_ADDR_MASK;
+	uint64_t attr_bits = desc &
+		~(TABLE_ADDR_MASK | DESC_MASK | UPPER_ATTRS(CONT_HINT));
+	uint64_t desc_type = ((level + 1U) == XLAT_TABLE_LEVEL_MAX) ?
+			     PAGE_DESC : BLOCK_DESC;
+	uint64_t *subtable;
+
+	assert(level < XLAT_TABLE_LEVEL_MAX);
+	assert((desc & DESC_MASK) == BLOCK_DESC);
+	assert((block_va & XLAT_BLOCK_MASK(level)) == 0U);
+	/* The Contiguous hint of the block must have been cleared first */
+	assert((desc & UPPER_ATTRS(CONT_HINT)) == 0U);
+
+	if (xlat_range_in_use(ctx, block_va,
+			      block_va + XLAT_BLOCK_SIZE(level) - 1U)) {
+		WARN("%s: Block at 0x%lx is in use and can't be split.\n",
+		     __func__, block_va);
+		return -EPERM;
+	}
+
+	subtable = xlat_table_get_empty(ctx);
+	if (subtable == NULL) {
+		WARN("%s: No free translation table to split block at 0x%lx.\n",
+		     __func__, block_va);
+		return -ENOMEM;
+	}
+
+#if PLAT_XLAT_TABLES_DYNAMIC
+	/*
+	 * Account the new table to all the regions it maps, like
+	 * xlat_tables_map_region() does for the tables it creates.
+	 */
+	ctx->tables_mapped_regions[xlat_table_get_index(ctx, subtable)] =
+		mmap_count_overlapping_regions(ctx, block_va,
+			block_va + XLAT_BLOCK_SIZE(level) - 1U, NULL);
+#endif
+
+	/*
+	 * The block is aligned to its size, so the new entries can all be
+	 * grouped by the Contiguous hint.
+	 */
+	if ((level + 1U) >= XLAT_CONT_MIN_LEVEL)
+		attr_bits |= UPPER_ATTRS(CONT_HINT);
+
+	for (unsigned int i = 0U; i < XLAT_TABLE_ENTRIES; i++) {
+		subtable[i] = attr_bits | desc_type | (block_pa +
+			((unsigned long long)i * XLAT_BLOCK_SIZE(level + 1U)));
+	}
+#if !(HW_ASSISTED_COHERENCY || WARMBOOT_ENABLE_DCACHE_EARLY)
+	xlat_clean_dcache_range((uintptr_t)subtable,
+		XLAT_TABLE_ENTRIES * sizeof(uint64_t));
+#endif
+
+	xlat_tables_replace_entry(ctx, entry, block_va, level,
+				  TABLE_DESC | (uintptr_t)subtable);
+
+	return 0;
+}
+
+int xlat_clear_contig(const xlat_ctx_t *ctx, uint64_t *entry, uintptr_t va,
+		      unsigned int level)
+{
+	uint64_t *group = entry -
+		((va >> XLAT_ADDR_SHIFT(level)) & (XLAT_CONT_ENTRIES - 1U));
+	uintptr_t group_va = va & ~XLAT_CONT_MASK(level);
+	uint64_t desc_type = (level == XLAT_TABLE_LEVEL_MAX) ?
+			     PAGE_DESC : BLOCK_DESC;
+
+	assert(level >= XLAT_CONT_MIN_LEVEL);
+	assert((*entry & UPPER_ATTRS(CONT_HINT)) != 0U);
+
+	if (xlat_range_in_use(ctx, group_va,
+			      group_va + XLAT_CONT_SIZE(level) - 1U)) {
+		WARN("%s: Group at 0x%lx is in use and can't be changed.\n",
+		     __func__, group_va);
+		return -EPERM;
+	}
+
+	/*
+	 * Break-before-make for the whole group: all its entries are made
+	 * invalid at once. They keep their other bits so that they can be
+	 * restored afterwards, the MMU ignores them.
+	 */
+	for (unsigned int i = 0U; i < XLAT_CONT_ENTRIES; i++) {
+		assert((group[i] & DESC_MASK) == desc_type);
+		group[i] &= ~(uint64_t)DESC_MASK;
+	}
+#if !(HW_ASSISTED_COHERENCY || WARMBOOT_ENABLE_DCACHE_EARLY)
+	xlat_clean_dcache_range((uintptr_t)group,
+		XLAT_CONT_ENTRIES * sizeof(uint64_t));
+#endif
+	if (level == XLAT_TABLE_LEVEL_MAX) {
+		xlat_arch_tlbi_va_range(group_va, XLAT_CONT_SIZE(level),
+					ctx->xlat_regime);
+	} else {
+		for (unsigned int i = 0U; i < XLAT_CONT_ENTRIES; i++)
+			xlat_arch_tlbi_va(group_va + (i * XLAT_BLOCK_SIZE(level)),
+					  ctx->xlat_regime);
+	}
+	xlat_arch_tlbi_va_sync();
+
+	for (unsigned int i = 0U; i < XLAT_CONT_ENTRIES; i++)
+		group[i] = (group[i] & ~UPPER_ATTRS(CONT_HINT)) | desc_type;
+#if !(HW_ASSISTED_COHERENCY || WARMBOOT_ENABLE_DCACHE_EARLY)
+	xlat_clean_dcache_range((uintptr_t)group,
+		XLAT_CONT_ENTRIES * sizeof(uint64_t));
+#endif
+	dsbish();
+
+	return 0;
+}
+
+#if PLAT_XLAT_TABLES_DYNAMIC
+
+bool xlat_coalesce_table(xlat_ctx_t *ctx, uint64_t *entry, uintptr_t table_va,
+			 unsigned int level)
+{
+	const mmap_region_t *mm = NULL;
+	uint64_t *subtable = (uint64_t *)(uintptr_t)(*entry & TABLE_ADDR_MASK);
+	uint64_t desc_type = ((level + 1U) == XLAT_TABLE_LEVEL_MAX) ?
+			     PAGE_DESC : BLOCK_DESC;
+	uintptr_t table_end_va = table_va + XLAT_BLOCK_SIZE(level) - 1U;
+	unsigned long long block_pa = subtable[0] & TABLE_ADDR_MASK;
+	uint64_t attr_bits = subtable[0] &
+		~(TABLE_ADDR_MASK | DESC_MASK | UPPER_ATTRS(CONT_HINT));
+
+	assert(level < XLAT_TABLE_LEVEL_MAX);
+	assert((*entry & DESC_MASK) == TABLE_DESC);
+	assert((table_va & XLAT_BLOCK_MASK(level)) == 0U);
+
+	if ((level < MIN_LVL_BLOCK_DESC) ||
+	    ((block_pa & XLAT_BLOCK_MASK(level)) != 0U) ||
+	    xlat_range_in_use(ctx, table_va, table_end_va))
+		return false;
+
+	/*
+	 * All the entries must map contiguous physical memory with the same
+	 * attributes, regardless of their Contiguous hint. The new block
+	 * doesn't get one, as its neighbours don't have it.
+	 */
+	for (unsigned int i = 0U; i < XLAT_TABLE_ENTRIES; i++) {
+		if ((subtable[i] & ~UPPER_ATTRS(CONT_HINT)) !=
+		    (attr_bits | desc_type | (block_pa +
+			((unsigned long long)i * XLAT_BLOCK_SIZE(level + 1U)))))
+			return false;
+	}
+
+	/*
+	 * Only use a block if xlat_tables_map_region() could have done it. A
+	 * single region must cover the whole block, so that unmapping a region
+	 * never has to deal with a partially covered block, and its
+	 * granularity must allow it.
+	 */
+	if ((mmap_count_overlapping_regions(ctx, table_va, table_end_va,
+					    &mm) != 1) ||
+	    (mm->base_va > table_va) ||
+	    ((mm->base_va + mm->size - 1U) < table_end_va) ||
+	    (mm->granularity < XLAT_BLOCK_SIZE(level)))
+		return false;
+
+	xlat_tables_replace_entry(ctx, entry, table_va, level,
+				  attr_bits | BLOCK_DESC | block_pa);
+
+	/* Release the table */
+	ctx->tables_mapped_regions[xlat_table_get_index(ctx, subtable)] = 0;
+
+	return true;
+}
+
+#endif /* PLAT_XLAT_TABLES_DYNAMIC */
+
+/*
+ * Returns the index of the mmap array at which the region ending at 'end_va'
+ * with the given size is stored, or should be inserted. The array is sorted by
+ * ascending end address and ascending size, see mmap_add_region_ctx(), so it
+ * can be searched by bisection.
+ */
+static int mmap_find_index(const xlat_ctx_t *ctx, uintptr_t end_va,
+			   size_t size)
+{
+	int low = 0;
+	int high = ctx->mmap_regions;
+
+	while (low < high) {
+		int mid = low + ((high - low) / 2);
+		const mmap_region_t *mm = &ctx->mmap[mid];
+		uintptr_t mm_end_va = mm->base_va + mm->size - 1U;
+
+		if ((mm_end_va < end_va) ||
+		    ((mm_end_va == end_va) && (mm->size < size)))
+			low = mid + 1;
+		else
+			high = mid;
+	}
+
+	return low;
+}
+
 /*
  * Function that verifies that a region can be mapped.
  * Returns:
@@ -695,10 +1056,16 @@ static int mmap_add_region_check(const xlat_ctx_t *ctx, const mmap_region_t *mm)
 		return -ERANGE;
 
 	/* Check that there is space in the ctx->mmap array */
-	if (ctx->mmap[ctx->mmap_num - 1].size != 0U)
+	if (ctx->mmap_regions >= ctx->mmap_num)
 		return -ENOMEM;
 
-	/* Check for PAs and VAs overlaps with all other regions */
+	/*
+	 * Check for PAs and VAs overlaps with all other regions. Unlike the
+	 * lookups of mmap_find_index(), this has to visit the whole array: it
+	 * is sorted by VA, which says nothing about where the regions whose
+	 * PAs overlap this one are, nor bounds how far back a larger region
+	 * enclosing this one in VA can be.
+	 */
 	for (const mmap_region_t *mm_cursor = ctx->mmap;
 	     mm_cursor->size != 0U; ++mm_cursor) {
 
@@ -761,12 +1128,11 @@ static int mmap_add_region_check(const xlat_ctx_t *ctx, const mmap_region_t *mm)
 
 void mmap_add_region_ctx(xlat_ctx_t *ctx, const mmap_region_t *mm)
 {
-	mmap_region_t *mm_cursor = ctx->mmap, *mm_destination;
-	const mmap_region_t *mm_end = ctx->mmap + ctx->mmap_num;
-	const mmap_region_t *mm_last;
+	mmap_region_t *mm_cursor;
+	const mmap_region_t *mm_end __unused = ctx->mmap + ctx->mmap_num;
 	unsigned long long end_pa = mm->base_pa + mm->size - 1U;
 	uintptr_t end_va = mm->base_va + mm->size - 1U;
-	int ret;
+	int ret, idx;
 
 	/* Ignore empty regions */
 	if (mm->size == 0U)
@@ -805,36 +1171,19 @@ void mmap_add_region_ctx(xlat_ctx_t *ctx, const mmap_region_t *mm)
 	 *
 	 * Overlapping is only allowed for static regions.
 	 */
-
-	while (((mm_cursor->base_va + mm_cursor->size - 1U) < end_va)
-	       && (mm_cursor->size != 0U)) {
-		++mm_cursor;
-	}
-
-	while (((mm_cursor->base_va + mm_cursor->size - 1U) == end_va) &&
-	       (mm_cursor->size != 0U) && (mm_cursor->size < mm->size)) {
-		++mm_cursor;
-	}
-
-	/*
-	 * Find the last entry marker in the mmap
-	 */
-	mm_last = ctx->mmap;
-	while ((mm_last->size != 0U) && (mm_last < mm_end)) {
-		++mm_last;
-	}
+	idx = mmap_find_index(ctx, end_va, mm->size);
+	mm_cursor = &ctx->mmap[idx];
 
 	/*
 	 * Check if we have enough space in the memory mapping table.
 	 * This shouldn't happen as we have checked in mmap_add_region_check
 	 * that there is free space.
 	 */
-	assert(mm_last->size == 0U);
+	assert(ctx->mmap[ctx->mmap_regions].size == 0U);
 
 	/* Make room for new region by moving other regions up by one place */
-	mm_destination = mm_cursor + 1;
-	(void)memmove(mm_destination, mm_cursor,
-		(uintptr_t)mm_last - (uintptr_t)mm_cursor);
+	(void)memmove(mm_cursor + 1, mm_cursor,
+		(size_t)(ctx->mmap_regions - idx) * sizeof(mmap_region_t));
 
 	/*
 	 * Check we haven't lost the empty sentinel from the end of the array.
@@ -844,6 +1193,7 @@ void mmap_add_region_ctx(xlat_ctx_t *ctx, const mmap_region_t *mm)
 	assert(mm_end->size == 0U);
 
 	*mm_cursor = *mm;
+	ctx->mmap_regions++;
 
 	if (end_pa > ctx->max_pa)
 		ctx->max_pa = end_pa;
@@ -939,11 +1289,11 @@ void mmap_add_ctx(xlat_ctx_t *ctx, const mmap_region_t *mm)
 
 int mmap_add_dynamic_region_ctx(xlat_ctx_t *ctx, mmap_region_t *mm)
 {
-	mmap_region_t *mm_cursor = ctx->mmap;
-	const mmap_region_t *mm_last = mm_cursor + ctx->mmap_num;
+	mmap_region_t *mm_cursor;
+	const mmap_region_t *mm_last __unused = ctx->mmap + ctx->mmap_num;
 	unsigned long long end_pa = mm->base_pa + mm->size - 1U;
 	uintptr_t end_va = mm->base_va + mm->size - 1U;
-	int ret;
+	int ret, idx;
 
 	/* Nothing to do */
 	if (mm->size == 0U)
@@ -960,20 +1310,12 @@ int mmap_add_dynamic_region_ctx(xlat_ctx_t *ctx, mmap_region_t *mm)
 	 * Find the adequate entry in the mmap array in the same way done for
 	 * static regions in mmap_add_region_ctx().
 	 */
-
-	while (((mm_cursor->base_va + mm_cursor->size - 1U) < end_va)
-	       && (mm_cursor->size != 0U)) {
-		++mm_cursor;
-	}
-
-	while (((mm_cursor->base_va + mm_cursor->size - 1U) == end_va) &&
-	       (mm_cursor->size != 0U) && (mm_cursor->size < mm->size)) {
-		++mm_cursor;
-	}
+	idx = mmap_find_index(ctx, end_va, mm->size);
+	mm_cursor = &ctx->mmap[idx];
 
 	/* Make room for new region by moving other regions up by one place */
 	(void)memmove(mm_cursor + 1U, mm_cursor,
-		     (uintptr_t)mm_last - (uintptr_t)mm_cursor);
+		(size_t)(ctx->mmap_regions - idx) * sizeof(mmap_region_t));
 
 	/*
 	 * Check we haven't lost the empty sentinal from the end of the array.
@@ -983,6 +1325,7 @@ int mmap_add_dynamic_region_ctx(xlat_ctx_t *ctx, mmap_region_t *mm)
 	assert(mm_last->size == 0U);
 
 	*mm_cursor = *mm;
+	ctx->mmap_regions++;
 
 	/*
 	 * Update the translation tables if the xlat tables are initialized. If
@@ -998,8 +1341,10 @@ int mmap_add_dynamic_region_ctx(xlat_ctx_t *ctx, mmap_region_t *mm)
 #endif
 		/* Failed to map, remove mmap entry, unmap and return error. */
 		if (end_va != (mm_cursor->base_va + mm_cursor->size - 1U)) {
+			ctx->mmap_regions--;
 			(void)memmove(mm_cursor, mm_cursor + 1U,
-				(uintptr_t)mm_last - (uintptr_t)mm_cursor);
+				(size_t)(ctx->mmap_regions - idx + 1) *
+				sizeof(mmap_region_t));
 
 			/*
 			 * Check if the mapping function actually managed to map
@@ -1025,6 +1370,10 @@ int mmap_add_dynamic_region_ctx(xlat_ctx_t *ctx, mmap_region_t *mm)
 			xlat_clean_dcache_range((uintptr_t)ctx->base_table,
 				ctx->base_table_entries * sizeof(uint64_t));
 #endif
+			xlat_arch_tlbi_va_range(unmap_mm.base_va,
+				round_up(unmap_mm.size, PAGE_SIZE),
+				ctx->xlat_regime);
+			xlat_arch_tlbi_va_sync();
 			return -ENOMEM;
 		}
 
@@ -1074,22 +1423,24 @@ int mmap_add_dynamic_region_alloc_va_ctx(xlat_ctx_t *ctx, mmap_region_t *mm)
 int mmap_remove_dynamic_region_ctx(xlat_ctx_t *ctx, uintptr_t base_va,
 				   size_t size)
 {
-	mmap_region_t *mm = ctx->mmap;
-	const mmap_region_t *mm_last = mm + ctx->mmap_num;
+	mmap_region_t *mm;
 	int update_max_va_needed = 0;
 	int update_max_pa_needed = 0;
+	int idx;
 
 	/* Check sanity of mmap array. */
-	assert(mm[ctx->mmap_num].size == 0U);
+	assert(ctx->mmap[ctx->mmap_num].size == 0U);
 
-	while (mm->size != 0U) {
-		if ((mm->base_va == base_va) && (mm->size == size))
-			break;
-		++mm;
-	}
+	/* Regions can't be empty, so a zero size can't match any of them */
+	if (size == 0U)
+		return -EINVAL;
+
+	idx = mmap_find_index(ctx, base_va + size - 1U, size);
+	mm = &ctx->mmap[idx];
 
 	/* Check that the region was found */
-	if (mm->size == 0U)
+	if ((idx == ctx->mmap_regions) || (mm->base_va != base_va) ||
+	    (mm->size != size))
 		return -EINVAL;
 
 	/* If the region is static it can't be removed */
@@ -1111,20 +1462,28 @@ int mmap_remove_dynamic_region_ctx(xlat_ctx_t *ctx, uintptr_t base_va,
 		xlat_clean_dcache_range((uintptr_t)ctx->base_table,
 			ctx->base_table_entries * sizeof(uint64_t));
 #endif
+		xlat_arch_tlbi_va_range(mm->base_va, mm->size,
+					ctx->xlat_regime);
 		xlat_arch_tlbi_va_sync();
 	}
 
-	/* Remove this region by moving the rest down by one place. */
-	(void)memmove(mm, mm + 1U, (uintptr_t)mm_last - (uintptr_t)mm);
+	/*
+	 * Remove this region by moving the rest down by one place, including
+	 * the empty sentinel that follows them.
+	 */
+	(void)memmove(mm, mm + 1U,
+		(size_t)(ctx->mmap_regions - idx) * sizeof(mmap_region_t));
+	ctx->mmap_regions--;
 
-	/* Check if we need to update the max VAs and PAs */
+	/*
+	 * Check if we need to update the max VAs and PAs. As the regions are
+	 * sorted by end VA, the max VA is the end VA of the last one.
+	 */
 	if (update_max_va_needed == 1) {
 		ctx->max_va = 0U;
-		mm = ctx->mmap;
-		while (mm->size != 0U) {
-			if ((mm->base_va + mm->size - 1U) > ctx->max_va)
-				ctx->max_va = mm->base_va + mm->size - 1U;
-			++mm;
+		if (ctx->mmap_regions > 0) {
+			mm = &ctx->mmap[ctx->mmap_regions - 1];
+			ctx->max_va = mm->base_va + mm->size - 1U;
 		}
 	}
 
@@ -1154,6 +1513,7 @@ void xlat_setup_dynamic_ctx(xlat_ctx_t *ctx, unsigned long long pa_max,
 
 	ctx->mmap = mmap;
 	ctx->mmap_num = mmap_num;
+	ctx->mmap_regions = 0;
 	memset(ctx->mmap, 0, sizeof(struct mmap_region) * mmap_num);
 
 	ctx->tables = (void *) tables;
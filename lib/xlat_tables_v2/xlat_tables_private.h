@@ -38,6 +38,21 @@
 
 #endif /* PLAT_XLAT_TABLES_DYNAMIC */
 
+/*
+ * Number of pages above which xlat_arch_tlbi_va_range() invalidates all the TLB
+ * entries of the translation regime instead of the ones of each page. This can
+ * be overridden by the platform in platform_def.h.
+ */
+#ifndef PLAT_XLAT_TLBI_RANGE_MAX_PAGES
+#define PLAT_XLAT_TLBI_RANGE_MAX_PAGES	U(512)
+#endif
+
+/*
+ * Lowest level at which the library sets the Contiguous hint. Groups of blocks
+ * of lower levels would be too big to ever be used.
+ */
+#define XLAT_CONT_MIN_LEVEL		U(2)
+
 extern uint64_t mmu_cfg_params[MMU_CFG_PARAM_MAX];
 
 /*
@@ -59,9 +74,22 @@ uint64_t xlat_arch_regime_get_xn_desc(int xlat_regime);
  */
 void xlat_arch_tlbi_va(uintptr_t va, int xlat_regime);
 
+/*
+ * Invalidate all TLB entries of the given translation regime that match a
+ * virtual address in the page-aligned range [va, va + size). All translation
+ * table writes done before calling it are made visible first, so it only needs
+ * to be called once for a batch of modified translation table entries.
+ *
+ * Depending on the size of the range, this is done with ARMv8.4-TLBI range
+ * operations when they are implemented, one invalidation per page, or by
+ * invalidating all TLB entries of the translation regime when the range is
+ * bigger than PLAT_XLAT_TLBI_RANGE_MAX_PAGES pages.
+ */
+void xlat_arch_tlbi_va_range(uintptr_t va, size_t size, int xlat_regime);
+
 /*
  * This function has to be called at the end of any code that uses the function
- * xlat_arch_tlbi_va().
+ * xlat_arch_tlbi_va() or xlat_arch_tlbi_va_range().
  */
 void xlat_arch_tlbi_va_sync(void);
 
@@ -80,6 +108,54 @@ void xlat_tables_print(xlat_ctx_t *ctx);
 uint64_t xlat_desc(const xlat_ctx_t *ctx, uint32_t attr,
 		   unsigned long long addr_pa, unsigned int level);
 
+/*
+ * Returns true if the VA range [base_va, end_va] must stay mapped while the
+ * translation tables of the context are changed, so the break-before-make
+ * sequence can't be applied to a block or group of entries that maps part of
+ * it. That is the case if the context is the one in use at the current
+ * exception level and the range overlaps the code of the image, the stack of
+ * this CPU, or the context and its translation tables.
+ */
+bool xlat_range_in_use(const xlat_ctx_t *ctx, uintptr_t base_va,
+		       uintptr_t end_va);
+
+/*
+ * Replaces the block descriptor pointed to by 'entry', which maps 'block_va' at
+ * the given level, by a new translation table whose descriptors map the same
+ * memory with the same attributes at the next level. The change follows the
+ * break-before-make sequence.
+ *
+ * Returns 0 on success, -EPERM if the block is in use (see
+ * xlat_range_in_use()) or -ENOMEM if there is no free translation table.
+ */
+int xlat_split_block(xlat_ctx_t *ctx, uint64_t *entry, uintptr_t block_va,
+		     unsigned int level);
+
+/*
+ * Clears the Contiguous hint of all the entries of the group that contains the
+ * entry pointed to by 'entry', which maps 'va' at the given level, following
+ * the break-before-make sequence. It must be done before changing any entry of
+ * a group without changing the others the same way.
+ *
+ * Returns 0 on success or -EPERM if the group is in use.
+ */
+int xlat_clear_contig(const xlat_ctx_t *ctx, uint64_t *entry, uintptr_t va,
+		      unsigned int level);
+
+#if PLAT_XLAT_TABLES_DYNAMIC
+/*
+ * Reverse of xlat_split_block(). If all the descriptors of the table pointed
+ * to by 'entry', which maps 'table_va' at the given level, map contiguous
+ * physical memory with the same attributes, replaces it by a block descriptor
+ * and releases the table. It is only done if the block could also have been
+ * created by mapping the region that covers it, and if the table isn't in use.
+ *
+ * Returns true if the table has been replaced by a block.
+ */
+bool xlat_coalesce_table(xlat_ctx_t *ctx, uint64_t *entry, uintptr_t table_va,
+			 unsigned int level);
+#endif
+
 /*
  * Architecture-specific initialization code.
  */
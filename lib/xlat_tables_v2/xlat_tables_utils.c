@@ -103,6 +103,10 @@ static void xlat_desc_print(const xlat_ctx_t *ctx, uint64_t desc)
 		printf("-GP");
 	}
 #endif
+
+	if ((desc & UPPER_ATTRS(CONT_HINT)) != 0ULL) {
+		printf("-CONT");
+	}
 }
 
 static const char * const level_spacers[] = {
@@ -117,11 +121,13 @@ static const char *invalid_descriptors_ommited =
 
 /*
  * Recursive function that reads the translation tables passed as an argument
- * and prints their status.
+ * and prints their status. It also counts the block and page descriptors, and
+ * how many of them have the Contiguous hint set.
  */
 static void xlat_tables_print_internal(xlat_ctx_t *ctx, uintptr_t table_base_va,
 		const uint64_t *table_base, unsigned int table_entries,
-		unsigned int level)
+		unsigned int level, unsigned int *leaf_count,
+		unsigned int *contig_count)
 {
 	assert(level <= XLAT_TABLE_LEVEL_MAX);
 
@@ -181,7 +187,8 @@ static void xlat_tables_print_internal(xlat_ctx_t *ctx, uintptr_t table_base_va,
 
 				xlat_tables_print_internal(ctx, table_idx_va,
 					(uint64_t *)addr_inner,
-					XLAT_TABLE_ENTRIES, level + 1U);
+					XLAT_TABLE_ENTRIES, level + 1U,
+					leaf_count, contig_count);
 			} else {
 				printf("%sVA:0x%lx PA:0x%llx size:0x%zx ",
 				       level_spacers[level], table_idx_va,
@@ -189,6 +196,10 @@ static void xlat_tables_print_internal(xlat_ctx_t *ctx, uintptr_t table_base_va,
 				       level_size);
 				xlat_desc_print(ctx, desc);
 				printf("\n");
+
+				(*leaf_count)++;
+				if ((desc & UPPER_ATTRS(CONT_HINT)) != 0ULL)
+					(*contig_count)++;
 			}
 		}
 
@@ -206,6 +217,7 @@ void xlat_tables_print(xlat_ctx_t *ctx)
 {
 	const char *xlat_regime_str;
 	int used_page_tables;
+	unsigned int leaf_count = 0U, contig_count = 0U;
 
 	if (ctx->xlat_regime == EL1_EL0_REGIME) {
 		xlat_regime_str = "1&0";
@@ -240,7 +252,11 @@ void xlat_tables_print(xlat_ctx_t *ctx)
 		ctx->tables_num - used_page_tables);
 
 	xlat_tables_print_internal(ctx, 0U, ctx->base_table,
-				   ctx->base_table_entries, ctx->base_level);
+				   ctx->base_table_entries, ctx->base_level,
+				   &leaf_count, &contig_count);
+
+	VERBOSE("  Contiguous hint set in %u out of %u block/page descriptors\n",
+		contig_count, leaf_count);
 }
 
 #endif /* LOG_LEVEL >= LOG_LEVEL_VERBOSE */
@@ -427,11 +443,107 @@ int xlat_get_mem_attributes_ctx(const xlat_ctx_t *ctx, uintptr_t base_va,
 }
 
 
-int xlat_change_mem_attributes_ctx(const xlat_ctx_t *ctx, uintptr_t base_va,
-				   size_t size, uint32_t attr)
+/*
+ * Makes sure that 'va' is the first address mapped by a translation table
+ * entry, splitting the block descriptors that map it across their boundaries.
+ * The Contiguous hint is also cleared from the groups of entries that 'va'
+ * splits, as their entries won't be changed the same way.
+ */
+static int xlat_split_at(xlat_ctx_t *ctx, uintptr_t va,
+			 unsigned long long virt_addr_space_size)
+{
+	for (;;) {
+		uint64_t *entry;
+		unsigned int level;
+		int ret;
+
+		entry = find_xlat_table_entry(va,
+					      ctx->base_table,
+					      ctx->base_table_entries,
+					      virt_addr_space_size,
+					      &level);
+		if (entry == NULL)
+			return 0;
+
+		if (((*entry & UPPER_ATTRS(CONT_HINT)) != 0U) &&
+		    ((va & XLAT_CONT_MASK(level)) != 0U)) {
+			ret = xlat_clear_contig(ctx, entry, va, level);
+			if (ret != 0)
+				return ret;
+		}
+
+		if ((va & XLAT_BLOCK_MASK(level)) == 0U)
+			return 0;
+
+		ret = xlat_split_block(ctx, entry, va & ~XLAT_BLOCK_MASK(level),
+				       level);
+		if (ret != 0)
+			return ret;
+	}
+}
+
+#if PLAT_XLAT_TABLES_DYNAMIC
+/*
+ * Returns a pointer to the entry at the given level of the translation tables
+ * that maps 'va', or NULL if the translation table walk doesn't reach that
+ * level.
+ */
+static uint64_t *find_xlat_table_entry_at_level(const xlat_ctx_t *ctx,
+						uintptr_t va,
+						unsigned int target_level)
 {
-	/* Note: This implementation isn't optimized. */
+	uint64_t *table = ctx->base_table;
+
+	assert(target_level >= ctx->base_level);
+
+	for (unsigned int level = ctx->base_level; level < target_level;
+	     ++level) {
+		uint64_t desc = table[XLAT_TABLE_IDX(va, level)];
+
+		if ((desc & DESC_MASK) != TABLE_DESC)
+			return NULL;
+
+		table = (uint64_t *)(uintptr_t)(desc & TABLE_ADDR_MASK);
+	}
+
+	return &table[XLAT_TABLE_IDX(va, target_level)];
+}
+
+/*
+ * Replaces by blocks the translation tables which map the VA range
+ * [base_va, end_va], or part of it, with the same attributes everywhere. The
+ * last level tables are done first so that the resulting blocks can in turn be
+ * coalesced at the previous level.
+ */
+static void xlat_coalesce_range(xlat_ctx_t *ctx, uintptr_t base_va,
+				uintptr_t end_va)
+{
+	unsigned int min_level = MAX(MIN_LVL_BLOCK_DESC, ctx->base_level);
+
+	for (unsigned int level = XLAT_TABLE_LEVEL_MAX - 1U; level >= min_level;
+	     --level) {
+		uintptr_t va = base_va & ~XLAT_BLOCK_MASK(level);
+
+		for (;;) {
+			uint64_t *entry;
+
+			entry = find_xlat_table_entry_at_level(ctx, va, level);
+			if ((entry != NULL) &&
+			    ((*entry & DESC_MASK) == TABLE_DESC))
+				(void)xlat_coalesce_table(ctx, entry, va, level);
+
+			if ((end_va - va) < XLAT_BLOCK_SIZE(level))
+				break;
+
+			va += XLAT_BLOCK_SIZE(level);
+		}
+	}
+}
+#endif /* PLAT_XLAT_TABLES_DYNAMIC */
 
+int xlat_change_mem_attributes_ctx(xlat_ctx_t *ctx, uintptr_t base_va,
+				   size_t size, uint32_t attr)
+{
 	assert(ctx != NULL);
 	assert(ctx->initialized);
 
@@ -462,46 +574,35 @@ int xlat_change_mem_attributes_ctx(const xlat_ctx_t *ctx, uintptr_t base_va,
 		return -EINVAL;
 	}
 
-	size_t pages_count = size / PAGE_SIZE;
+	uintptr_t end_va = base_va + size - 1U;
+	uintptr_t va;
+	int ret;
 
 	VERBOSE("Changing memory attributes of %zu pages starting from address 0x%lx...\n",
-		pages_count, base_va);
-
-	uintptr_t base_va_original = base_va;
+		size / PAGE_SIZE, base_va);
 
 	/*
-	 * Sanity checks.
+	 * Sanity checks. Every block or page descriptor that maps a part of the
+	 * region is checked once.
 	 */
-	for (size_t i = 0U; i < pages_count; ++i) {
+	va = base_va;
+	for (;;) {
 		const uint64_t *entry;
 		uint64_t desc, attr_index;
 		unsigned int level;
 
-		entry = find_xlat_table_entry(base_va,
+		entry = find_xlat_table_entry(va,
 					      ctx->base_table,
 					      ctx->base_table_entries,
 					      virt_addr_space_size,
 					      &level);
 		if (entry == NULL) {
-			WARN("Address 0x%lx is not mapped.\n", base_va);
+			WARN("Address 0x%lx is not mapped.\n", va);
 			return -EINVAL;
 		}
 
 		desc = *entry;
 
-		/*
-		 * Check that all the required pages are mapped at page
-		 * granularity.
-		 */
-		if (((desc & DESC_MASK) != PAGE_DESC) ||
-			(level != XLAT_TABLE_LEVEL_MAX)) {
-			WARN("Address 0x%lx is not mapped at the right granularity.\n",
-			     base_va);
-			WARN("Granularity is 0x%llx, should be 0x%x.\n",
-			     (unsigned long long)XLAT_BLOCK_SIZE(level), PAGE_SIZE);
-			return -EINVAL;
-		}
-
 		/*
 		 * If the region type is device, it shouldn't be executable.
 		 */
@@ -509,67 +610,155 @@ int xlat_change_mem_attributes_ctx(const xlat_ctx_t *ctx, uintptr_t base_va,
 		if (attr_index == ATTR_DEVICE_INDEX) {
 			if ((attr & MT_EXECUTE_NEVER) == 0U) {
 				WARN("Setting device memory as executable at address 0x%lx.",
-				     base_va);
+				     va);
 				return -EINVAL;
 			}
 		}
 
-		base_va += PAGE_SIZE;
+		/* Move to the first VA mapped by the next descriptor. */
+		va = (va & ~XLAT_BLOCK_MASK(level)) + XLAT_BLOCK_SIZE(level);
+		if ((va - 1U) >= end_va)
+			break;
 	}
 
-	/* Restore original value. */
-	base_va = base_va_original;
+	/*
+	 * Split the blocks that are only partially covered by the region, so
+	 * that the region is mapped by descriptors that it fully covers. If
+	 * this fails, the mapping is equivalent and the memory attributes are
+	 * unchanged.
+	 */
+	ret = xlat_split_at(ctx, base_va, virt_addr_space_size);
+	if (ret != 0)
+		return ret;
+
+	if (end_va < ctx->va_max_address) {
+		ret = xlat_split_at(ctx, end_va + 1U, virt_addr_space_size);
+		if (ret != 0)
+			return ret;
+	}
 
-	for (unsigned int i = 0U; i < pages_count; ++i) {
+	/*
+	 * The break-before-make sequence requires writing an invalid descriptor
+	 * and making sure that the system sees the change before writing the
+	 * new descriptor. It is done for all the consecutive block or page
+	 * descriptors of one table at a time, so that the TLB maintenance is
+	 * batched and only waited for once per batch.
+	 */
+	va = base_va;
+	for (;;) {
+		uint64_t *entries;
+		uint64_t desc_type;
+		size_t desc_size, batch_count, max_count;
+		unsigned int level;
 
-		uint32_t old_attr = 0U, new_attr;
-		uint64_t *entry = NULL;
-		unsigned int level = 0U;
-		unsigned long long addr_pa = 0ULL;
+		entries = find_xlat_table_entry(va,
+						ctx->base_table,
+						ctx->base_table_entries,
+						virt_addr_space_size,
+						&level);
+		assert(entries != NULL);
+
+		desc_type = (level == XLAT_TABLE_LEVEL_MAX) ?
+			    PAGE_DESC : BLOCK_DESC;
+		desc_size = XLAT_BLOCK_SIZE(level);
+
+		/* Stop at the end of the table or of the region */
+		max_count = (XLAT_BLOCK_SIZE(level - 1U) -
+			     (va & XLAT_BLOCK_MASK(level - 1U))) / desc_size;
+		max_count = MIN(max_count,
+				(size_t)((end_va - va) / desc_size) + 1U);
+
+		for (batch_count = 0U; batch_count < max_count; ++batch_count) {
+			if ((entries[batch_count] & DESC_MASK) != desc_type)
+				break;
+		}
 
-		(void) xlat_get_mem_attributes_internal(ctx, base_va, &old_attr,
-					    &entry, &addr_pa, &level);
+		for (unsigned int i = 0U; i < batch_count; ++i) {
 
-		/*
-		 * From attr, only MT_RO/MT_RW, MT_EXECUTE/MT_EXECUTE_NEVER and
-		 * MT_USER/MT_PRIVILEGED are taken into account. Any other
-		 * information is ignored.
-		 */
+			uint32_t old_attr = 0U, new_attr;
+			unsigned long long addr_pa = 0ULL;
 
-		/* Clean the old attributes so that they can be rebuilt. */
-		new_attr = old_attr & ~(MT_RW | MT_EXECUTE_NEVER | MT_USER);
+			(void) xlat_get_mem_attributes_internal(ctx,
+					va + (i * desc_size), &old_attr,
+					NULL, &addr_pa, NULL);
 
-		/*
-		 * Update attributes, but filter out the ones this function
-		 * isn't allowed to change.
-		 */
-		new_attr |= attr & (MT_RW | MT_EXECUTE_NEVER | MT_USER);
+			/*
+			 * From attr, only MT_RO/MT_RW,
+			 * MT_EXECUTE/MT_EXECUTE_NEVER and MT_USER/MT_PRIVILEGED
+			 * are taken into account. Any other information is
+			 * ignored.
+			 */
 
-		/*
-		 * The break-before-make sequence requires writing an invalid
-		 * descriptor and making sure that the system sees the change
-		 * before writing the new descriptor.
-		 */
-		*entry = INVALID_DESC;
+			/*
+			 * Clean the old attributes so that they can be
+			 * rebuilt.
+			 */
+			new_attr = old_attr &
+				   ~(MT_RW | MT_EXECUTE_NEVER | MT_USER);
+
+			/*
+			 * Update attributes, but filter out the ones this
+			 * function isn't allowed to change.
+			 */
+			new_attr |= attr & (MT_RW | MT_EXECUTE_NEVER | MT_USER);
+
+			/*
+			 * Write the new descriptor with its type bits cleared.
+			 * The MMU ignores the other bits of an invalid
+			 * descriptor, so this keeps the new descriptor at hand
+			 * until it can be made valid. Groups of entries with
+			 * the Contiguous hint are entirely in the region, so
+			 * they all change the same way and can keep it.
+			 */
+			entries[i] = (xlat_desc(ctx, new_attr, addr_pa, level) |
+				      (entries[i] & UPPER_ATTRS(CONT_HINT))) &
+				     ~(uint64_t)DESC_MASK;
+		}
 #if !HW_ASSISTED_COHERENCY
-		dccvac((uintptr_t)entry);
+		clean_dcache_range((uintptr_t)entries,
+				   batch_count * sizeof(uint64_t));
 #endif
-		/* Invalidate any cached copy of this mapping in the TLBs. */
-		xlat_arch_tlbi_va(base_va, ctx->xlat_regime);
 
-		/* Ensure completion of the invalidation. */
+		/*
+		 * Invalidate any cached copy of these mappings in the TLBs and
+		 * ensure completion of the invalidation. A single invalidation
+		 * drops the TLB entries of a whole block.
+		 */
+		if (level == XLAT_TABLE_LEVEL_MAX) {
+			xlat_arch_tlbi_va_range(va, batch_count * PAGE_SIZE,
+						ctx->xlat_regime);
+		} else {
+			for (unsigned int i = 0U; i < batch_count; ++i)
+				xlat_arch_tlbi_va(va + (i * desc_size),
+						  ctx->xlat_regime);
+		}
 		xlat_arch_tlbi_va_sync();
 
-		/* Write new descriptor */
-		*entry = xlat_desc(ctx, new_attr, addr_pa, level);
+		/* Write new descriptors */
+		for (unsigned int i = 0U; i < batch_count; ++i)
+			entries[i] |= desc_type;
 #if !HW_ASSISTED_COHERENCY
-		dccvac((uintptr_t)entry);
+		clean_dcache_range((uintptr_t)entries,
+				   batch_count * sizeof(uint64_t));
 #endif
-		base_va += PAGE_SIZE;
+
+		if ((end_va - va) < (batch_count * desc_size))
+			break;
+
+		va += batch_count * desc_size;
 	}
 
 	/* Ensure that the last descriptor writen is seen by the system. */
 	dsbish();
 
+#if PLAT_XLAT_TABLES_DYNAMIC
+	/*
+	 * Turn back into blocks the tables that now map memory with the same
+	 * attributes everywhere, e.g. after restoring the attributes of a part
+	 * of a block that had been split.
+	 */
+	xlat_coalesce_range(ctx, base_va, end_va);
+#endif
+
 	return 0;
 }
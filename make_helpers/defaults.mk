@@ -36,6 +36,9 @@ BL2_IN_XIP_MEM			:= 0
 # Do dcache invalidate upon BL2 entry at EL3
 BL2_INV_DCACHE			:= 1
 
+# Hash images on a secondary CPU while BL2 at EL3 loads them
+BL2_PARALLEL_HASH		:= 0
+
 # Select the branch protection features to use.
 BRANCH_PROTECTION		:= 0
 
@@ -57,6 +60,9 @@ CTX_INCLUDE_AARCH32_REGS	:= 1
 # Include FP registers in cpu context
 CTX_INCLUDE_FPREGS		:= 0
 
+# Switch the FP registers in cpu context lazily, on first access
+CTX_LAZY_FPREGS			:= 0
+
 # Include pointer authentication (ARMv8.3-PAuth) registers in cpu context. This
 # must be set to 1 if the platform wants to use this feature in the Secure
 # world. It is not needed to use it in the Non-secure world.
@@ -75,6 +81,12 @@ DISABLE_BIN_GENERATION		:= 0
 # development platforms.
 DYN_DISABLE_AUTH		:= 0
 
+# Record log messages in binary form instead of printing them
+ENABLE_BINARY_LOG		:= 0
+
+# Buffer BL31 runtime console output in per-CPU memory rings
+ENABLE_CONSOLE_RING		:= 0
+
 # Build option to enable MPAM for lower ELs
 ENABLE_MPAM_FOR_LOWER_ELS	:= 0
 
@@ -90,6 +102,12 @@ ENABLE_PSCI_STAT		:= 0
 # Flag to enable runtime instrumentation using PMF
 ENABLE_RUNTIME_INSTRUMENTATION	:= 0
 
+# Build flag to dispatch hot SMCs through per-function fast path handlers
+ENABLE_SMC_FAST_PATH		:= 0
+
+# Build flag to record per-SMC latency histograms in BL31
+ENABLE_SMC_LATENCY_STATS	:= 0
+
 # Flag to enable stack corruption protection
 ENABLE_STACK_PROTECTOR		:= 0
 
@@ -128,6 +146,9 @@ GENERATE_COT			:= 0
 # default, they are for Secure EL1.
 GICV2_G0_FOR_EL3		:= 0
 
+# Only restore the GICv3 context registers which don't hold their reset value
+GICV3_SPARSE_CTX_RESTORE	:= 0
+
 # Route External Aborts to EL3. Disabled by default; External Aborts are handled
 # by lower ELs.
 HANDLE_EA_EL3_FIRST		:= 0
@@ -152,6 +173,10 @@ PL011_GENERIC_UART		:= 0
 # The platform Makefile is free to override this value.
 PROGRAMMABLE_RESET_ADDRESS	:= 0
 
+# Use per power domain atomic state words instead of locks for PSCI state
+# coordination
+PSCI_ATOMIC_COORDINATION	:= 0
+
 # Flag used to choose the power state format: Extended State-ID or Original
 PSCI_EXTENDED_STATE_ID		:= 0
 
@@ -4,7 +4,13 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#include <errno.h>
+
+#include <drivers/arm/fvp/fvp_pwrc.h>
+#include <lib/mmio.h>
 #include <plat/arm/common/plat_arm.h>
+#include <plat/common/platform.h>
+#include <platform_def.h>
 
 #include "fvp_private.h"
 
@@ -28,3 +34,31 @@ void bl2_el3_early_platform_setup(u_register_t arg0 __unused,
 	 */
 	fvp_interconnect_enable();
 }
+
+#if BL2_PARALLEL_HASH
+/*
+ * Power on the second CPU of the cluster of the primary CPU. Like on a PSCI
+ * CPU_ON, it finds a warm reset in the power controller and jumps to the entry
+ * point in the trusted mailbox. Once parked, it powers itself off again.
+ */
+int bl2_el3_plat_release_secondary(uintptr_t entrypoint)
+{
+#if (FVP_MAX_CPUS_PER_CLUSTER > 1) && (FVP_MAX_PE_PER_CPU == 1)
+	unsigned int mpidr = FVP_PRIMARY_CPU + 1U;
+	unsigned int psysr;
+
+	/* The CPU must have powered itself off after its cold boot first */
+	do {
+		mmio_write_32(PWRC_BASE + PSYSR_OFF, mpidr);
+		psysr = mmio_read_32(PWRC_BASE + PSYSR_OFF);
+	} while ((psysr & PSYSR_AFF_L0) != 0U);
+
+	mmio_write_64(PLAT_ARM_TRUSTED_MAILBOX_BASE, entrypoint);
+	mmio_write_32(PWRC_BASE + PPONR_OFF, mpidr);
+
+	return 0;
+#else
+	return -ENOTSUP;
+#endif
+}
+#endif /* BL2_PARALLEL_HASH */
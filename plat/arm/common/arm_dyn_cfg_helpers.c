@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2018-2020, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -71,7 +71,7 @@ int arm_dyn_get_config_load_info(void *dtb, int node, unsigned int config_id,
 	assert(fdt_check_header(dtb) == 0);
 
 	/* Assert the node offset point to "arm,tb_fw" compatible property */
-	assert(node == fdt_node_offset_by_compatible(dtb, -1, "arm,tb_fw"));
+	assert(node == fdtw_node_offset_by_compatible(dtb, -1, "arm,tb_fw"));
 
 	err = fdtw_read_cells(dtb, node, prop_names[i].config_addr, 2,
 				(void *) config_addr);
@@ -118,7 +118,7 @@ int arm_dyn_get_disable_auth(void *dtb, int node, uint32_t *disable_auth)
 	assert(fdt_check_header(dtb) == 0);
 
 	/* Assert the node offset point to "arm,tb_fw" compatible property */
-	assert(node == fdt_node_offset_by_compatible(dtb, -1, "arm,tb_fw"));
+	assert(node == fdtw_node_offset_by_compatible(dtb, -1, "arm,tb_fw"));
 
 	/* Locate the disable_auth cell and read the value */
 	err = fdtw_read_cells(dtb, node, "disable_auth", 1, disable_auth);
@@ -159,7 +159,7 @@ int arm_dyn_tb_fw_cfg_init(void *dtb, int *node)
 	}
 
 	/* Assert the node offset point to "arm,tb_fw" compatible property */
-	*node = fdt_node_offset_by_compatible(dtb, -1, "arm,tb_fw");
+	*node = fdtw_node_offset_by_compatible(dtb, -1, "arm,tb_fw");
 	if (*node < 0) {
 		WARN("The compatible property `arm,tb_fw` not found in the config\n");
 		return -1;
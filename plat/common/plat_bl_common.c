@@ -18,6 +18,7 @@
  * may redefine with strong definition.
  */
 #pragma weak bl2_el3_plat_prepare_exit
+#pragma weak bl2_el3_plat_release_secondary
 #pragma weak plat_error_handler
 #pragma weak bl2_plat_preload_setup
 #pragma weak bl2_plat_handle_pre_image_load
@@ -28,6 +29,11 @@ void bl2_el3_plat_prepare_exit(void)
 {
 }
 
+int bl2_el3_plat_release_secondary(uintptr_t entrypoint)
+{
+	return -ENOTSUP;
+}
+
 void __dead2 plat_error_handler(int err)
 {
 	while (1)
@@ -108,13 +108,16 @@ u_register_t plat_psci_stat_get_residency(unsigned int lvl,
 	/*
 	 * If power down is requested, then timestamp capture will
 	 * be with caches OFF.  Hence we have to do cache maintenance
-	 * when reading the timestamp.
+	 * when reading the timestamp. With hardware-assisted coherency,
+	 * data caches stay enabled on the power down path, so no cache
+	 * maintenance is needed.
 	 */
 	state = state_info->pwr_domain_state[PSCI_CPU_PWR_LVL];
-	if (is_local_state_off(state) != 0) {
+	if ((is_local_state_off(state) != 0) && (HW_ASSISTED_COHERENCY == 0)) {
 		pmf_flags = PMF_CACHE_MAINT;
 	} else {
-		assert(is_local_state_retn(state) == 1);
+		assert((is_local_state_off(state) != 0) ||
+		       (is_local_state_retn(state) == 1));
 		pmf_flags = PMF_NO_CACHE_MAINT;
 	}
 
@@ -1,5 +1,5 @@
 #
-# Copyright (c) 2017-2019, ARM Limited and Contributors. All rights reserved.
+# Copyright (c) 2017-2020, ARM Limited and Contributors. All rights reserved.
 #
 # SPDX-License-Identifier: BSD-3-Clause
 #
@@ -99,20 +99,42 @@ $(ROTPK_HASH): $(ROT_KEY)
 
 endif
 
+# Compressed images are decompressed according to their format, so each image
+# can use its own, e.g. with BL33_PRE_TOOL_FILTER=GZIP
 ifeq (${FIP_GZIP},1)
 
 include lib/zlib/zlib.mk
 
-BL2_SOURCES		+=	common/image_decompress.c		\
-				$(ZLIB_SOURCES)
+BL2_SOURCES		+=	$(ZLIB_SOURCES)
 
 $(eval $(call add_define,UNIPHIER_DECOMPRESS_GZIP))
 
+UNIPHIER_COMPRESS	:= GZIP
+
+endif
+
+ifeq (${FIP_LZ4},1)
+
+include lib/lz4/lz4.mk
+
+BL2_SOURCES		+=	$(LZ4_SOURCES)
+
+$(eval $(call add_define,UNIPHIER_DECOMPRESS_LZ4))
+
+# LZ4 is faster to decompress, so it is preferred if both are enabled
+UNIPHIER_COMPRESS	:= LZ4
+
+endif
+
+ifneq (${UNIPHIER_COMPRESS},)
+
+BL2_SOURCES		+=	common/image_decompress.c
+
 # compress all images loaded by BL2
-SCP_BL2_PRE_TOOL_FILTER	:= GZIP
-BL31_PRE_TOOL_FILTER	:= GZIP
-BL32_PRE_TOOL_FILTER	:= GZIP
-BL33_PRE_TOOL_FILTER	:= GZIP
+SCP_BL2_PRE_TOOL_FILTER	?= ${UNIPHIER_COMPRESS}
+BL31_PRE_TOOL_FILTER	?= ${UNIPHIER_COMPRESS}
+BL32_PRE_TOOL_FILTER	?= ${UNIPHIER_COMPRESS}
+BL33_PRE_TOOL_FILTER	?= ${UNIPHIER_COMPRESS}
 
 endif
 
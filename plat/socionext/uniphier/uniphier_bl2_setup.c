@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2017-2020, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -18,9 +18,16 @@
 #ifdef UNIPHIER_DECOMPRESS_GZIP
 #include <tf_gunzip.h>
 #endif
+#ifdef UNIPHIER_DECOMPRESS_LZ4
+#include <tf_unlz4.h>
+#endif
 
 #include "uniphier.h"
 
+#if defined(UNIPHIER_DECOMPRESS_GZIP) || defined(UNIPHIER_DECOMPRESS_LZ4)
+#define UNIPHIER_DECOMPRESS
+#endif
+
 #define BL2_SIZE		((BL2_END) - (BL2_BASE))
 
 static int uniphier_bl2_kick_scp;
@@ -118,16 +125,25 @@ bl_params_t *plat_get_next_bl_params(void)
 
 void bl2_plat_preload_setup(void)
 {
-#ifdef UNIPHIER_DECOMPRESS_GZIP
+#ifdef UNIPHIER_DECOMPRESS
+	/* Each image is decompressed according to its format */
 	image_decompress_init(UNIPHIER_IMAGE_BUF_BASE,
 			      UNIPHIER_IMAGE_BUF_SIZE,
-			      gunzip);
+			      NULL);
+#endif
+#ifdef UNIPHIER_DECOMPRESS_GZIP
+	(void)image_decompress_add_format((const uint8_t *)GZIP_MAGIC,
+					  GZIP_MAGIC_LEN, gunzip);
+#endif
+#ifdef UNIPHIER_DECOMPRESS_LZ4
+	(void)image_decompress_add_format((const uint8_t *)LZ4_MAGIC,
+					  LZ4_MAGIC_LEN, unlz4);
 #endif
 }
 
 int bl2_plat_handle_pre_image_load(unsigned int image_id)
 {
-#ifdef UNIPHIER_DECOMPRESS_GZIP
+#ifdef UNIPHIER_DECOMPRESS
 	image_decompress_prepare(uniphier_get_image_info(image_id));
 #endif
 	return 0;
@@ -135,7 +151,7 @@ int bl2_plat_handle_pre_image_load(unsigned int image_id)
 
 int bl2_plat_handle_post_image_load(unsigned int image_id)
 {
-#ifdef UNIPHIER_DECOMPRESS_GZIP
+#ifdef UNIPHIER_DECOMPRESS
 	struct image_info *image_info;
 	int ret;
 
@@ -121,6 +121,40 @@ static uintptr_t arm_arch_svc_smc_handler(uint32_t smc_fid,
 	}
 }
 
+#if ENABLE_SMC_FAST_PATH && (WORKAROUND_CVE_2017_5715 || WORKAROUND_CVE_2018_3639)
+/*
+ * Fast path handler for the SMCCC_ARCH_WORKAROUND_* calls. As for the
+ * top-level handler, the workarounds have already been applied on entry to EL3.
+ */
+static uintptr_t arm_arch_svc_workaround_handler(uint32_t smc_fid,
+	u_register_t x1,
+	u_register_t x2,
+	u_register_t x3,
+	u_register_t x4,
+	void *cookie,
+	void *handle,
+	u_register_t flags)
+{
+	SMC_RET0(handle);
+}
+#endif
+
+#if ENABLE_SMC_FAST_PATH && WORKAROUND_CVE_2017_5715
+DECLARE_RT_SVC_FAST_FN(
+		arm_arch_svc_workaround_1,
+		SMCCC_ARCH_WORKAROUND_1,
+		arm_arch_svc_workaround_handler
+);
+#endif
+
+#if ENABLE_SMC_FAST_PATH && WORKAROUND_CVE_2018_3639
+DECLARE_RT_SVC_FAST_FN(
+		arm_arch_svc_workaround_2,
+		SMCCC_ARCH_WORKAROUND_2,
+		arm_arch_svc_workaround_handler
+);
+#endif
+
 /* Register Standard Service Calls as runtime service */
 DECLARE_RT_SVC(
 		arm_arch_svc,
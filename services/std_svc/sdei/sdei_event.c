@@ -6,6 +6,7 @@
 
 #include <assert.h>
 
+#include <drivers/arm/gic_common.h>
 #include <lib/utils.h>
 
 #include "sdei_private.h"
@@ -51,6 +52,77 @@ sdei_entry_t *get_event_entry(sdei_ev_map_t *map)
 	}
 }
 
+/*
+ * Index + 1 of the event mapping each interrupt is bound to, or 0 if it isn't
+ * bound to any. SGIs and PPIs index private mappings, and SPIs index shared
+ * mappings. Entries are updated when dynamic events are bound and released,
+ * and are read locklessly.
+ */
+static uint16_t sdei_intr_map_idx[MAX_SPI_ID + 1U];
+
+static const sdei_mapping_t *intr_mapping(unsigned int intr_num)
+{
+	return (intr_num < MIN_SPI_ID) ? SDEI_PRIVATE_MAPPING() :
+		SDEI_SHARED_MAPPING();
+}
+
+/* Hash an event number into a slot of the event lookup table */
+static unsigned int event_lookup_slot(int ev_num)
+{
+	return ((uint32_t) ev_num * 0x9E3779B1U) % sdei_event_lookup_slots;
+}
+
+/*
+ * Populate the event lookup table and record the interrupts of the statically
+ * bound events. Must be called once before any other lookup.
+ */
+void init_event_lookup(void)
+{
+	const sdei_mapping_t *mapping;
+	sdei_ev_map_t *map;
+	unsigned int i, j, slot;
+
+	for_each_mapping_type(i, mapping) {
+		assert(mapping->num_maps < UINT16_MAX);
+
+		iterate_mapping(mapping, j, map) {
+			slot = event_lookup_slot(map->ev_num);
+			while (sdei_event_lookup_table[slot] != NULL) {
+				/* Event numbers must be unique */
+				assert(sdei_event_lookup_table[slot]->ev_num !=
+						map->ev_num);
+				slot = (slot + 1U) % sdei_event_lookup_slots;
+			}
+			sdei_event_lookup_table[slot] = map;
+
+			if (map->intr != SDEI_DYN_IRQ)
+				add_intr_map(map);
+		}
+	}
+}
+
+/* Record the interrupt that a mapping is now bound to */
+void add_intr_map(sdei_ev_map_t *map)
+{
+	const sdei_mapping_t *mapping = intr_mapping(map->intr);
+
+	assert(map->intr <= MAX_SPI_ID);
+	assert(is_event_private(map) == (mapping == SDEI_PRIVATE_MAPPING()));
+
+	sdei_intr_map_idx[map->intr] = (uint16_t) (MAP_OFF(map, mapping) + 1);
+}
+
+/* Forget the interrupt that a mapping is about to be released from */
+void remove_intr_map(sdei_ev_map_t *map)
+{
+	const sdei_mapping_t *mapping = intr_mapping(map->intr);
+
+	assert(map->intr <= MAX_SPI_ID);
+
+	if (sdei_intr_map_idx[map->intr] == (MAP_OFF(map, mapping) + 1))
+		sdei_intr_map_idx[map->intr] = 0U;
+}
+
 /*
  * Find event mapping for a given interrupt number: On success, returns pointer
  * to the event mapping. On error, returns NULL.
@@ -59,20 +131,33 @@ sdei_ev_map_t *find_event_map_by_intr(unsigned int intr_num, bool shared)
 {
 	const sdei_mapping_t *mapping;
 	sdei_ev_map_t *map;
-	unsigned int i;
+	unsigned int i, idx;
+
+	mapping = shared ? SDEI_SHARED_MAPPING() : SDEI_PRIVATE_MAPPING();
 
 	/*
-	 * Look for a match in private and shared mappings, as requested. This
-	 * is a linear search. However, if the mappings are required to be
-	 * sorted, for large maps, we could consider binary search.
+	 * Free dynamic mappings and explicit events all have their interrupt
+	 * set as SDEI_DYN_IRQ, so they aren't in the interrupt table. Finding
+	 * a free slot is only needed to bind an interrupt, so a linear search
+	 * is good enough here.
 	 */
-	mapping = shared ? SDEI_SHARED_MAPPING() : SDEI_PRIVATE_MAPPING();
-	iterate_mapping(mapping, i, map) {
-		if (map->intr == intr_num)
-			return map;
+	if (intr_num == SDEI_DYN_IRQ) {
+		iterate_mapping(mapping, i, map) {
+			if (map->intr == intr_num)
+				return map;
+		}
+
+		return NULL;
 	}
 
-	return NULL;
+	if ((intr_num > MAX_SPI_ID) || (intr_mapping(intr_num) != mapping))
+		return NULL;
+
+	idx = sdei_intr_map_idx[intr_num];
+	if (idx == 0U)
+		return NULL;
+
+	return &mapping->map[idx - 1U];
 }
 
 /*
@@ -81,20 +166,20 @@ sdei_ev_map_t *find_event_map_by_intr(unsigned int intr_num, bool shared)
  */
 sdei_ev_map_t *find_event_map(int ev_num)
 {
-	const sdei_mapping_t *mapping;
 	sdei_ev_map_t *map;
-	unsigned int i, j;
+	unsigned int slot;
 
 	/*
-	 * Iterate through mappings to find a match. This is a linear search.
-	 * However, if the mappings are required to be sorted, for large maps,
-	 * we could consider binary search.
+	 * Probe the event lookup table, which is never more than half full,
+	 * until either the event or an empty slot is found.
 	 */
-	for_each_mapping_type(i, mapping) {
-		iterate_mapping(mapping, j, map) {
-			if (map->ev_num == ev_num)
-				return map;
-		}
+	slot = event_lookup_slot(ev_num);
+	for (map = sdei_event_lookup_table[slot]; map != NULL;
+			map = sdei_event_lookup_table[slot]) {
+		if (map->ev_num == ev_num)
+			return map;
+
+		slot = (slot + 1U) % sdei_event_lookup_slots;
 	}
 
 	return NULL;
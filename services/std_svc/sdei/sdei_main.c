@@ -226,6 +226,8 @@ static void sdei_class_init(sdei_class_t class)
 /* SDEI dispatcher initialisation */
 void sdei_init(void)
 {
+	init_event_lookup();
+
 	sdei_class_init(SDEI_CRITICAL);
 	sdei_class_init(SDEI_NORMAL);
 
@@ -745,6 +747,7 @@ static int sdei_interrupt_bind(unsigned int intr_num)
 		if (!is_map_bound(map)) {
 			map->intr = intr_num;
 			set_map_bound(map);
+			add_intr_map(map);
 			retry = false;
 		}
 		sdei_map_unlock(map);
@@ -802,6 +805,7 @@ static int sdei_interrupt_release(int ev_num)
 		 * during unregister.
 		 */
 
+		remove_intr_map(map);
 		map->intr = SDEI_DYN_IRQ;
 		clr_map_bound(map);
 	} else {
@@ -227,9 +227,14 @@ static inline void sdei_map_unlock(sdei_ev_map_t *map)
 extern const sdei_mapping_t sdei_global_mappings[];
 extern sdei_entry_t sdei_private_event_table[];
 extern sdei_entry_t sdei_shared_event_table[];
+extern sdei_ev_map_t *sdei_event_lookup_table[];
+extern const unsigned int sdei_event_lookup_slots;
 
 void init_sdei_state(void);
 
+void init_event_lookup(void);
+void add_intr_map(sdei_ev_map_t *map);
+void remove_intr_map(sdei_ev_map_t *map);
 sdei_ev_map_t *find_event_map_by_intr(unsigned int intr_num, bool shared);
 sdei_ev_map_t *find_event_map(int ev_num);
 sdei_entry_t *get_event_entry(sdei_ev_map_t *map);
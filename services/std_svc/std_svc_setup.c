@@ -143,6 +143,47 @@ static uintptr_t std_svc_smc_handler(uint32_t smc_fid,
 	}
 }
 
+#if ENABLE_SMC_FAST_PATH
+/*
+ * Fast path handler for PSCI_CPU_SUSPEND_AARCH64, which is called by the idle
+ * loop of the normal world.
+ */
+static uintptr_t std_svc_psci_cpu_suspend_handler(uint32_t smc_fid,
+			     u_register_t x1,
+			     u_register_t x2,
+			     u_register_t x3,
+			     u_register_t x4,
+			     void *cookie,
+			     void *handle,
+			     u_register_t flags)
+{
+	u_register_t ret;
+
+#if ENABLE_RUNTIME_INSTRUMENTATION
+	PMF_WRITE_TIMESTAMP(rt_instr_svc,
+	    RT_INSTR_ENTER_PSCI,
+	    PMF_CACHE_MAINT,
+	    get_cpu_data(cpu_data_pmf_ts[CPU_DATA_PMF_TS0_IDX]));
+#endif
+
+	ret = psci_cpu_suspend_smc_handler(x1, x2, x3, flags);
+
+#if ENABLE_RUNTIME_INSTRUMENTATION
+	PMF_CAPTURE_TIMESTAMP(rt_instr_svc,
+	    RT_INSTR_EXIT_PSCI,
+	    PMF_NO_CACHE_MAINT);
+#endif
+
+	SMC_RET1(handle, ret);
+}
+
+DECLARE_RT_SVC_FAST_FN(
+		std_svc_psci_cpu_suspend,
+		PSCI_CPU_SUSPEND_AARCH64,
+		std_svc_psci_cpu_suspend_handler
+);
+#endif /* ENABLE_SMC_FAST_PATH */
+
 /* Register Standard Service Calls as runtime service */
 DECLARE_RT_SVC(
 		std_svc,
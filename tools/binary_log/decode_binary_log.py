@@ -0,0 +1,219 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2020, Arm Limited. All rights reserved.
+#
+# SPDX-License-Identifier: BSD-3-Clause
+#
+
+"""
+Decode the binary log written by TF-A images built with ENABLE_BINARY_LOG=1.
+
+The log is read from a dump of its memory region, and the format strings from
+the ELF files of the images which wrote it, e.g.:
+
+    decode_binary_log.py log.bin build/fvp/debug/bl1/bl1.elf \\
+        build/fvp/debug/bl2/bl2.elf build/fvp/debug/bl31/bl31.elf
+
+The layout of the log is described in include/common/tf_log_bin.h.
+"""
+
+import argparse
+import struct
+import sys
+
+LOG_MAGIC = 0x4c424654
+LOG_VERSION = 1
+LOG_HDR = struct.Struct('<6I')
+RECORD_HDR = struct.Struct('<HBBi')
+
+ANCHOR_SYMBOL = 'tf_log_bin_image'
+
+# Same prefixes as plat_log_get_prefix()
+LOG_PREFIXES = {10: 'ERROR:   ', 20: 'NOTICE:  ', 30: 'WARNING: ',
+                40: 'INFO:    ', 50: 'VERBOSE: '}
+
+SHT_SYMTAB = 2
+PT_LOAD = 1
+
+
+class Image:
+    """Format strings of the image described by an ELF file."""
+
+    def __init__(self, path):
+        with open(path, 'rb') as elf:
+            self.data = elf.read()
+
+        ident = self.data[:16]
+        if ident[:4] != b'\x7fELF':
+            sys.exit('{}: not an ELF file'.format(path))
+        if ident[5] != 1:
+            sys.exit('{}: not a little-endian ELF file'.format(path))
+        self.is64 = ident[4] == 2
+
+        if self.is64:
+            (self.phoff, self.shoff) = struct.unpack_from('<QQ', self.data, 32)
+            (self.phentsize, self.phnum, self.shentsize, self.shnum) = \
+                struct.unpack_from('<HHHH', self.data, 54)
+        else:
+            (self.phoff, self.shoff) = struct.unpack_from('<II', self.data, 28)
+            (self.phentsize, self.phnum, self.shentsize, self.shnum) = \
+                struct.unpack_from('<HHHH', self.data, 42)
+
+        self.anchor = self.find_symbol(ANCHOR_SYMBOL)
+        if self.anchor is None:
+            sys.exit('{}: no {} symbol, was it built with '
+                     'ENABLE_BINARY_LOG=1?'.format(path, ANCHOR_SYMBOL))
+        self.image_id = struct.unpack('<I', self.read(self.anchor, 4))[0]
+
+    def section(self, index):
+        off = self.shoff + index * self.shentsize
+        if self.is64:
+            (sh_type, _, _, sh_offset, sh_size, sh_link, _, _, sh_entsize) = \
+                struct.unpack_from('<IQQQQIIQQ', self.data, off + 4)
+        else:
+            (sh_type, _, _, sh_offset, sh_size, sh_link, _, _, sh_entsize) = \
+                struct.unpack_from('<IIIIIIIII', self.data, off + 4)
+        return (sh_type, sh_offset, sh_size, sh_link, sh_entsize)
+
+    def find_symbol(self, name):
+        for index in range(self.shnum):
+            (sh_type, offset, size, link, entsize) = self.section(index)
+            if sh_type != SHT_SYMTAB:
+                continue
+            strtab = self.section(link)[1]
+            for sym in range(offset, offset + size, entsize):
+                if self.is64:
+                    (st_name, _, _, _, st_value) = \
+                        struct.unpack_from('<IBBHQ', self.data, sym)
+                else:
+                    (st_name, st_value) = \
+                        struct.unpack_from('<II', self.data, sym)
+                end = self.data.index(b'\0', strtab + st_name)
+                if self.data[strtab + st_name:end] == name.encode():
+                    return st_value
+        return None
+
+    def read(self, addr, size=None):
+        """Read 'size' bytes, or a NUL-terminated string, at 'addr'."""
+        for index in range(self.phnum):
+            off = self.phoff + index * self.phentsize
+            if self.is64:
+                (p_type, _, p_offset, p_vaddr, _, p_filesz) = \
+                    struct.unpack_from('<IIQQQQ', self.data, off)
+            else:
+                (p_type, p_offset, p_vaddr, _, p_filesz) = \
+                    struct.unpack_from('<IIIII', self.data, off)
+            if p_type != PT_LOAD or not p_vaddr <= addr < p_vaddr + p_filesz:
+                continue
+            start = p_offset + addr - p_vaddr
+            if size is None:
+                return self.data[start:self.data.index(b'\0', start)]
+            return self.data[start:start + size]
+        raise ValueError('address 0x{:x} is not in the image'.format(addr))
+
+
+def format_number(unum, radix, padn):
+    digits = '{:x}'.format(unum) if radix == 16 else '{:d}'.format(unum)
+    return digits.rjust(padn, '0') if padn > 0 else digits
+
+
+def format_record(fmt, args):
+    """Format the arguments like vprintf() in lib/libc/printf.c does."""
+    out = []
+    i = 0
+    while i < len(fmt):
+        if fmt[i] != '%':
+            out.append(fmt[i])
+            i += 1
+            continue
+
+        i += 1
+        padn = 0
+        while i < len(fmt) and fmt[i] in 'lz0':
+            if fmt[i] == '0':
+                j = i + 1
+                while j < len(fmt) and fmt[j].isdigit():
+                    j += 1
+                padn = int(fmt[i + 1:j] or '0')
+                i = j
+            else:
+                i += 1
+        if i >= len(fmt):
+            break
+
+        spec = fmt[i]
+        i += 1
+        if spec == 's':
+            end = args.index(b'\0')
+            out.append(args[:end].decode('ascii', 'replace'))
+            args = args[end + 1:]
+            continue
+        if spec not in 'diuxp':
+            break
+
+        (num,) = struct.unpack_from('<q' if spec in 'di' else '<Q', args)
+        args = args[8:]
+        if spec in 'di':
+            if num < 0:
+                out.append('-')
+                padn -= 1
+            out.append(format_number(abs(num), 10, padn))
+        elif spec == 'p':
+            if num > 0:
+                out.append('0x')
+                padn -= 2
+            out.append(format_number(num, 16, padn))
+        else:
+            out.append(format_number(num, 16 if spec == 'x' else 10, padn))
+
+    return ''.join(out)
+
+
+def decode(log, images, output):
+    (magic, version, size, used, dropped, _) = LOG_HDR.unpack_from(log)
+    if magic != LOG_MAGIC or version != LOG_VERSION:
+        sys.exit('No binary log found in the dump')
+    if LOG_HDR.size + used > min(size, len(log)):
+        sys.exit('Truncated binary log')
+
+    off = LOG_HDR.size
+    end = LOG_HDR.size + used
+    while off < end:
+        (rec_size, image_id, _, fmt_off) = RECORD_HDR.unpack_from(log, off)
+        if rec_size < RECORD_HDR.size or off + rec_size > end:
+            output.write('<corrupted record at offset {}>\n'.format(off))
+            break
+
+        image = images.get(image_id)
+        if image is None:
+            output.write('<record from unknown image {}>\n'.format(image_id))
+        else:
+            fmt = image.read(image.anchor + fmt_off).decode('ascii', 'replace')
+            args = log[off + RECORD_HDR.size:off + rec_size]
+            output.write(LOG_PREFIXES.get(ord(fmt[0]), ''))
+            output.write(format_record(fmt[1:], args))
+        off += rec_size
+
+    if dropped != 0:
+        output.write('<{} records dropped, the log was full>\n'.format(dropped))
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Decode the binary log written by TF-A images.')
+    parser.add_argument('log', help='dump of the memory region of the log')
+    parser.add_argument('elf', nargs='+',
+                        help='ELF files of the images which wrote the log')
+    args = parser.parse_args()
+
+    images = {}
+    for path in args.elf:
+        image = Image(path)
+        images[image.image_id] = image
+
+    with open(args.log, 'rb') as log:
+        decode(log.read(), images, sys.stdout)
+
+
+if __name__ == '__main__':
+    main()
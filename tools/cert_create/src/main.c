@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015-2019, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2020, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -7,14 +7,17 @@
 #include <assert.h>
 #include <ctype.h>
 #include <getopt.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include <unistd.h>
 
 #include <openssl/conf.h>
 #include <openssl/engine.h>
 #include <openssl/err.h>
+#include <openssl/opensslv.h>
 #include <openssl/pem.h>
 #include <openssl/sha.h>
 #include <openssl/x509v3.h>
@@ -74,22 +77,14 @@ static int key_size;
 static int new_keys;
 static int save_keys;
 static int print_cert;
+static unsigned int nr_jobs = 1;
+static const char *hash_cache;
 
 /* Info messages created in the Makefile */
 extern const char build_msg[];
 extern const char platform_msg[];
 
 
-static char *strdup(const char *str)
-{
-	int n = strlen(str) + 1;
-	char *dup = malloc(n);
-	if (dup) {
-		strcpy(dup, str);
-	}
-	return dup;
-}
-
 static const char *key_algs_str[] = {
 	[KEY_ALG_RSA] = "rsa",
 #ifndef OPENSSL_NO_EC
@@ -168,6 +163,18 @@ static int get_key_size(const char *key_size_str)
 	return key_size;
 }
 
+static int get_nr_jobs(const char *nr_jobs_str)
+{
+	char *end;
+	long nr;
+
+	nr = strtol(nr_jobs_str, &end, 10);
+	if (*end != '\0')
+		return -1;
+
+	return nr;
+}
+
 static int get_hash_alg(const char *hash_alg_str)
 {
 	int i;
@@ -297,25 +304,198 @@ static const cmd_opt_t common_cmd_opt[] = {
 	{
 		{ "print-cert", no_argument, NULL, 'p' },
 		"Print the certificates in the standard output"
+	},
+	{
+		{ "jobs", required_argument, NULL, 'j' },
+		"Number of threads used to load the keys, hash the images and sign the certificates (default: number of CPUs)"
+	},
+	{
+		{ "hash-cache", required_argument, NULL, 'c' },
+		"File to keep the image hashes in across runs. Images which have not changed since are not hashed again"
 	}
 };
 
+typedef struct parallel_work_s {
+	void (*fn)(size_t idx, void *arg);
+	void *arg;
+	size_t nr;
+	size_t next;
+	pthread_mutex_t lock;
+} parallel_work_t;
+
+static void *parallel_worker(void *data)
+{
+	parallel_work_t *work = data;
+	size_t idx;
+
+	for (;;) {
+		pthread_mutex_lock(&work->lock);
+		idx = work->next++;
+		pthread_mutex_unlock(&work->lock);
+
+		if (idx >= work->nr) {
+			return NULL;
+		}
+		work->fn(idx, work->arg);
+	}
+}
+
+/* Call fn(idx, arg) for each idx lower than nr, on up to nr_jobs threads */
+static void run_parallel(size_t nr, void (*fn)(size_t idx, void *arg),
+			 void *arg)
+{
+	parallel_work_t work = { .fn = fn, .arg = arg, .nr = nr };
+	size_t i, nr_threads = (nr < nr_jobs) ? nr : nr_jobs;
+	pthread_t *threads;
+
+	if (nr_threads <= 1) {
+		for (i = 0; i < nr; i++) {
+			fn(i, arg);
+		}
+		return;
+	}
+
+	CHECK_NULL(threads, malloc(nr_threads * sizeof(*threads)));
+	pthread_mutex_init(&work.lock, NULL);
+	for (i = 0; i < nr_threads; i++) {
+		if (pthread_create(&threads[i], NULL, parallel_worker,
+				   &work) != 0) {
+			ERROR("Cannot create thread\n");
+			exit(1);
+		}
+	}
+	for (i = 0; i < nr_threads; i++) {
+		pthread_join(threads[i], NULL);
+	}
+	pthread_mutex_destroy(&work.lock);
+	free(threads);
+}
+
+/* Load a private key from its file, or generate a new one */
+static void load_key(size_t idx, void *arg)
+{
+	int *loaded = arg;
+	key_t *key = &keys[idx];
+	unsigned int err_code;
+
+	if (!key_new(key)) {
+		ERROR("Failed to allocate key container\n");
+		return;
+	}
+
+	/* First try to load the key from disk */
+	if (key_load(key, &err_code)) {
+		/* Key loaded successfully */
+		loaded[idx] = 1;
+		return;
+	}
+
+	/* Key not loaded. Check the error code */
+	if (err_code == KEY_ERR_LOAD) {
+		/* File exists, but it does not contain a valid private
+		 * key. Abort. */
+		ERROR("Error loading '%s'\n", key->fn);
+		return;
+	}
+
+	/* File does not exist, could not be opened or no filename was
+	 * given */
+	if (new_keys) {
+		/* Try to create a new key */
+		NOTICE("Creating new key for '%s'\n", key->desc);
+		if (!key_create(key, key_alg, key_size)) {
+			ERROR("Error creating key '%s'\n", key->desc);
+			return;
+		}
+		loaded[idx] = 1;
+	} else {
+		if (err_code == KEY_ERR_OPEN) {
+			ERROR("Error opening '%s'\n", key->fn);
+		} else {
+			ERROR("Key '%s' not specified\n", key->desc);
+		}
+	}
+}
+
+typedef struct hash_job_s {
+	unsigned char (*md)[SHA512_DIGEST_LENGTH];
+	int *hashed;
+} hash_job_t;
+
+/* Calculate the hash of the image of a hash extension */
+static void hash_image(size_t idx, void *arg)
+{
+	hash_job_t *job = arg;
+	ext_t *ext = &extensions[idx];
+
+	if ((ext->type != EXT_TYPE_HASH) || (ext->arg == NULL)) {
+		job->hashed[idx] = 1;
+		return;
+	}
+
+	if (!sha_file(hash_alg, ext->arg, job->md[idx])) {
+		ERROR("Cannot calculate hash of %s\n", ext->arg);
+		return;
+	}
+	job->hashed[idx] = 1;
+}
+
+typedef struct sign_job_s {
+	STACK_OF(X509_EXTENSION) **sk;
+	unsigned int *ready;
+	int *signed_ok;
+} sign_job_t;
+
+/* Create a certificate, signed with the key of its issuer */
+static void sign_cert(size_t idx, void *arg)
+{
+	sign_job_t *job = arg;
+	unsigned int i = job->ready[idx];
+
+	if (!cert_new(hash_alg, &certs[i], VAL_DAYS, 0, job->sk[i])) {
+		ERROR("Cannot create %s\n", certs[i].cn);
+		return;
+	}
+	job->signed_ok[i] = 1;
+}
+
+/*
+ * Index of the certificate which must be created before 'cert', or -1. The
+ * certificates are created in order, so an issuer certificate which comes later
+ * is not available and the certificate is self-signed instead.
+ */
+static int cert_dependency(unsigned int cert)
+{
+	unsigned int issuer = certs[cert].issuer;
+
+	if ((issuer < cert) && (certs[issuer].fn != NULL)) {
+		return issuer;
+	}
+
+	return -1;
+}
+
 int main(int argc, char *argv[])
 {
 	STACK_OF(X509_EXTENSION) * sk;
+	STACK_OF(X509_EXTENSION) **cert_sk;
 	X509_EXTENSION *cert_ext = NULL;
 	ext_t *ext;
 	key_t *key;
 	cert_t *cert;
 	FILE *file;
-	int i, j, ext_nid, nvctr;
+	int i, j, ext_nid, nvctr, dep;
 	int c, opt_idx = 0;
 	const struct option *cmd_opt;
 	const char *cur_opt;
-	unsigned int err_code;
+	unsigned char (*ext_md)[SHA512_DIGEST_LENGTH];
 	unsigned char md[SHA512_DIGEST_LENGTH];
 	unsigned int  md_len;
+	unsigned int num_ready;
+	int *done;
 	const EVP_MD *md_info;
+	hash_job_t hash_job;
+	sign_job_t sign_job;
 
 	NOTICE("CoT Generation Tool: %s\n", build_msg);
 	NOTICE("Target platform: %s\n", platform_msg);
@@ -324,6 +504,12 @@ int main(int argc, char *argv[])
 	key_alg = KEY_ALG_RSA;
 	hash_alg = HASH_ALG_SHA256;
 	key_size = -1;
+#if OPENSSL_VERSION_NUMBER >= 0x10100000L && defined(_SC_NPROCESSORS_ONLN)
+	/* Older OpenSSL versions are only thread safe with locking callbacks */
+	if (sysconf(_SC_NPROCESSORS_ONLN) > 1) {
+		nr_jobs = sysconf(_SC_NPROCESSORS_ONLN);
+	}
+#endif
 
 	/* Add common command line options */
 	for (i = 0; i < NUM_ELEM(common_cmd_opt); i++) {
@@ -353,7 +539,7 @@ int main(int argc, char *argv[])
 
 	while (1) {
 		/* getopt_long stores the option index here. */
-		c = getopt_long(argc, argv, "a:b:hknps:", cmd_opt, &opt_idx);
+		c = getopt_long(argc, argv, "a:b:c:hj:knps:", cmd_opt, &opt_idx);
 
 		/* Detect the end of the options. */
 		if (c == -1) {
@@ -375,9 +561,22 @@ int main(int argc, char *argv[])
 				exit(1);
 			}
 			break;
+		case 'c':
+			hash_cache = optarg;
+			break;
 		case 'h':
 			print_help(argv[0], cmd_opt);
 			exit(0);
+		case 'j':
+			c = get_nr_jobs(optarg);
+			if (c <= 0) {
+				ERROR("Invalid number of jobs '%s'\n", optarg);
+				exit(1);
+			}
+#if OPENSSL_VERSION_NUMBER >= 0x10100000L
+			nr_jobs = c;
+#endif
+			break;
 		case 'k':
 			save_keys = 1;
 			break;
@@ -438,44 +637,35 @@ int main(int argc, char *argv[])
 	}
 
 	/* Load private keys from files (or generate new ones) */
+	CHECK_NULL(done, calloc(num_keys, sizeof(*done)));
+	run_parallel(num_keys, load_key, done);
 	for (i = 0 ; i < num_keys ; i++) {
-		if (!key_new(&keys[i])) {
-			ERROR("Failed to allocate key container\n");
-			exit(1);
-		}
-
-		/* First try to load the key from disk */
-		if (key_load(&keys[i], &err_code)) {
-			/* Key loaded successfully */
-			continue;
-		}
-
-		/* Key not loaded. Check the error code */
-		if (err_code == KEY_ERR_LOAD) {
-			/* File exists, but it does not contain a valid private
-			 * key. Abort. */
-			ERROR("Error loading '%s'\n", keys[i].fn);
+		if (!done[i]) {
 			exit(1);
 		}
+	}
+	free(done);
 
-		/* File does not exist, could not be opened or no filename was
-		 * given */
-		if (new_keys) {
-			/* Try to create a new key */
-			NOTICE("Creating new key for '%s'\n", keys[i].desc);
-			if (!key_create(&keys[i], key_alg, key_size)) {
-				ERROR("Error creating key '%s'\n", keys[i].desc);
-				exit(1);
-			}
-		} else {
-			if (err_code == KEY_ERR_OPEN) {
-				ERROR("Error opening '%s'\n", keys[i].fn);
-			} else {
-				ERROR("Key '%s' not specified\n", keys[i].desc);
-			}
+	/* Calculate the hash of the images */
+	if ((hash_cache != NULL) && !sha_cache_load(hash_cache)) {
+		ERROR("Cannot load hash cache %s\n", hash_cache);
+		exit(1);
+	}
+	CHECK_NULL(hash_job.md, calloc(num_extensions, sizeof(*hash_job.md)));
+	CHECK_NULL(hash_job.hashed, calloc(num_extensions, sizeof(int)));
+	run_parallel(num_extensions, hash_image, &hash_job);
+	for (i = 0 ; i < num_extensions ; i++) {
+		if (!hash_job.hashed[i]) {
 			exit(1);
 		}
 	}
+	if ((hash_cache != NULL) && !sha_cache_save(hash_cache)) {
+		WARN("Cannot save hash cache %s\n", hash_cache);
+	}
+	ext_md = hash_job.md;
+	free(hash_job.hashed);
+
+	CHECK_NULL(cert_sk, calloc(num_certs, sizeof(*cert_sk)));
 
 	/* Create the certificates */
 	for (i = 0 ; i < num_certs ; i++) {
@@ -485,6 +675,7 @@ int main(int argc, char *argv[])
 		/* Create a new stack of extensions. This stack will be used
 		 * to create the certificate */
 		CHECK_NULL(sk, sk_X509_EXTENSION_new_null());
+		cert_sk[i] = sk;
 
 		for (j = 0 ; j < cert->num_ext ; j++) {
 
@@ -517,12 +708,8 @@ int main(int argc, char *argv[])
 						break;
 					}
 				} else {
-					/* Calculate the hash of the file */
-					if (!sha_file(hash_alg, ext->arg, md)) {
-						ERROR("Cannot calculate hash of %s\n",
-							ext->arg);
-						exit(1);
-					}
+					memcpy(md, ext_md[cert->ext[j]],
+					       SHA512_DIGEST_LENGTH);
 				}
 				CHECK_NULL(cert_ext, ext_new_hash(ext_nid,
 						EXT_CRIT, md_info, md,
@@ -541,15 +728,48 @@ int main(int argc, char *argv[])
 			/* Push the extension into the stack */
 			sk_X509_EXTENSION_push(sk, cert_ext);
 		}
+	}
+	free(ext_md);
+
+	/*
+	 * Create the certificates. Signed with corresponding key, in rounds of
+	 * certificates whose issuer certificate has been created.
+	 */
+	CHECK_NULL(done, calloc(num_certs, sizeof(*done)));
+	CHECK_NULL(sign_job.ready, calloc(num_certs, sizeof(unsigned int)));
+	CHECK_NULL(sign_job.signed_ok, calloc(num_certs, sizeof(int)));
+	sign_job.sk = cert_sk;
+	for (i = 0 ; i < num_certs ; i++) {
+		if (certs[i].fn == NULL) {
+			done[i] = 1;
+		}
+	}
+	do {
+		num_ready = 0;
+		for (i = 0 ; i < num_certs ; i++) {
+			dep = cert_dependency(i);
+			if (!done[i] && ((dep < 0) || done[dep])) {
+				sign_job.ready[num_ready++] = i;
+			}
+		}
 
-		/* Create certificate. Signed with corresponding key */
-		if (cert->fn && !cert_new(hash_alg, cert, VAL_DAYS, 0, sk)) {
-			ERROR("Cannot create %s\n", cert->cn);
-			exit(1);
+		run_parallel(num_ready, sign_cert, &sign_job);
+
+		for (j = 0 ; j < num_ready ; j++) {
+			if (!sign_job.signed_ok[sign_job.ready[j]]) {
+				exit(1);
+			}
+			done[sign_job.ready[j]] = 1;
 		}
+	} while (num_ready > 0);
 
-		sk_X509_EXTENSION_free(sk);
+	for (i = 0 ; i < num_certs ; i++) {
+		sk_X509_EXTENSION_free(cert_sk[i]);
 	}
+	free(cert_sk);
+	free(sign_job.ready);
+	free(sign_job.signed_ok);
+	free(done);
 
 
 	/* Print the certificates */
@@ -1,55 +1,420 @@
 /*
- * Copyright (c) 2015-2017, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2020, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#include <errno.h>
+#include <fcntl.h>
 #include <openssl/sha.h>
+#include <pthread.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
 #include "debug.h"
 #include "key.h"
+#include "sha.h"
 
-#define BUFFER_SIZE	256
+/* Size of the buffer used to read the files which cannot be mapped */
+#define BUFFER_SIZE		(1024 * 1024)
 
+#define SHA_CACHE_HEADER	"cert_create hash cache v1"
+/* Maximum number of digests kept in the cache file */
+#define SHA_CACHE_MAX_ENTRIES	1024
+
+typedef struct sha_ctx_s {
+	int md_alg;
+	union {
+		SHA256_CTX sha256;
+		SHA512_CTX sha512;
+	} u;
+} sha_ctx_t;
+
+/*
+ * A file is identified by its device and inode numbers, and its content is
+ * assumed unchanged as long as its size and timestamps are. The change time
+ * cannot be set by users, so it is updated by any write to the file.
+ */
+typedef struct sha_cache_entry_s {
+	int md_alg;
+	unsigned long long dev;
+	unsigned long long ino;
+	unsigned long long size;
+	long long mtime_sec;
+	long mtime_nsec;
+	long long ctime_sec;
+	long ctime_nsec;
+	int used;		/* Looked up or added during this run */
+	unsigned char md[SHA512_DIGEST_LENGTH];
+} sha_cache_entry_t;
+
+static sha_cache_entry_t *sha_cache;
+static unsigned int sha_cache_num;
+static unsigned int sha_cache_max;
+static int sha_cache_enabled;
+static pthread_mutex_t sha_cache_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static unsigned int sha_md_len(int md_alg)
+{
+	if (md_alg == HASH_ALG_SHA384) {
+		return SHA384_DIGEST_LENGTH;
+	} else if (md_alg == HASH_ALG_SHA512) {
+		return SHA512_DIGEST_LENGTH;
+	} else {
+		return SHA256_DIGEST_LENGTH;
+	}
+}
+
+static void sha_init(sha_ctx_t *ctx, int md_alg)
+{
+	ctx->md_alg = md_alg;
+	if (md_alg == HASH_ALG_SHA384) {
+		SHA384_Init(&ctx->u.sha512);
+	} else if (md_alg == HASH_ALG_SHA512) {
+		SHA512_Init(&ctx->u.sha512);
+	} else {
+		SHA256_Init(&ctx->u.sha256);
+	}
+}
+
+static void sha_update(sha_ctx_t *ctx, const void *data, size_t len)
+{
+	if (ctx->md_alg == HASH_ALG_SHA384) {
+		SHA384_Update(&ctx->u.sha512, data, len);
+	} else if (ctx->md_alg == HASH_ALG_SHA512) {
+		SHA512_Update(&ctx->u.sha512, data, len);
+	} else {
+		SHA256_Update(&ctx->u.sha256, data, len);
+	}
+}
+
+static void sha_final(sha_ctx_t *ctx, unsigned char *md)
+{
+	if (ctx->md_alg == HASH_ALG_SHA384) {
+		SHA384_Final(md, &ctx->u.sha512);
+	} else if (ctx->md_alg == HASH_ALG_SHA512) {
+		SHA512_Final(md, &ctx->u.sha512);
+	} else {
+		SHA256_Final(md, &ctx->u.sha256);
+	}
+}
+
+static void sha_cache_key(sha_cache_entry_t *entry, int md_alg,
+			  const struct stat *st)
+{
+	memset(entry, 0, sizeof(*entry));
+	entry->md_alg = md_alg;
+	entry->dev = st->st_dev;
+	entry->ino = st->st_ino;
+	entry->size = st->st_size;
+	entry->mtime_sec = st->st_mtim.tv_sec;
+	entry->mtime_nsec = st->st_mtim.tv_nsec;
+	entry->ctime_sec = st->st_ctim.tv_sec;
+	entry->ctime_nsec = st->st_ctim.tv_nsec;
+}
+
+/* Return the cache entry of the same file, whatever its content was */
+static sha_cache_entry_t *sha_cache_find(const sha_cache_entry_t *key)
+{
+	unsigned int i;
+
+	for (i = 0; i < sha_cache_num; i++) {
+		if ((sha_cache[i].md_alg == key->md_alg) &&
+		    (sha_cache[i].dev == key->dev) &&
+		    (sha_cache[i].ino == key->ino)) {
+			return &sha_cache[i];
+		}
+	}
+
+	return NULL;
+}
+
+static int sha_cache_match(const sha_cache_entry_t *entry,
+			   const sha_cache_entry_t *key)
+{
+	return (entry->size == key->size) &&
+		(entry->mtime_sec == key->mtime_sec) &&
+		(entry->mtime_nsec == key->mtime_nsec) &&
+		(entry->ctime_sec == key->ctime_sec) &&
+		(entry->ctime_nsec == key->ctime_nsec);
+}
+
+static int sha_cache_add(const sha_cache_entry_t *entry)
+{
+	sha_cache_entry_t *cache;
+	unsigned int max;
+
+	if (sha_cache_num == sha_cache_max) {
+		max = (sha_cache_max == 0) ? 16 : (sha_cache_max * 2);
+		cache = realloc(sha_cache, max * sizeof(*sha_cache));
+		if (cache == NULL) {
+			return 0;
+		}
+		sha_cache = cache;
+		sha_cache_max = max;
+	}
+
+	sha_cache[sha_cache_num++] = *entry;
+	return 1;
+}
+
+static int sha_cache_lookup(sha_cache_entry_t *key)
+{
+	sha_cache_entry_t *entry;
+	int found = 0;
+
+	pthread_mutex_lock(&sha_cache_lock);
+	entry = sha_cache_find(key);
+	if ((entry != NULL) && sha_cache_match(entry, key)) {
+		memcpy(key->md, entry->md, sizeof(key->md));
+		entry->used = 1;
+		found = 1;
+	}
+	pthread_mutex_unlock(&sha_cache_lock);
+
+	return found;
+}
+
+static void sha_cache_update(const sha_cache_entry_t *key)
+{
+	sha_cache_entry_t *entry;
+
+	/*
+	 * A file written again within the granularity of its timestamps keeps
+	 * them, so only cache the digest of files which have not changed for
+	 * a while.
+	 */
+	if (key->ctime_sec >= (long long)time(NULL) - 1) {
+		return;
+	}
+
+	pthread_mutex_lock(&sha_cache_lock);
+	entry = sha_cache_find(key);
+	if (entry != NULL) {
+		*entry = *key;
+		entry->used = 1;
+	} else if (sha_cache_add(key)) {
+		sha_cache[sha_cache_num - 1].used = 1;
+	}
+	pthread_mutex_unlock(&sha_cache_lock);
+}
+
+static void sha_data(int md_alg, const void *data, size_t len,
+		     unsigned char *md)
+{
+	sha_ctx_t ctx;
+
+	sha_init(&ctx, md_alg);
+	sha_update(&ctx, data, len);
+	sha_final(&ctx, md);
+}
+
+static int sha_stream(int md_alg, int fd, unsigned char *md)
+{
+	sha_ctx_t ctx;
+	unsigned char *data;
+	ssize_t bytes;
+
+	data = malloc(BUFFER_SIZE);
+	if (data == NULL) {
+		return 0;
+	}
+
+	sha_init(&ctx, md_alg);
+	while ((bytes = read(fd, data, BUFFER_SIZE)) != 0) {
+		if (bytes < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			free(data);
+			return 0;
+		}
+		sha_update(&ctx, data, bytes);
+	}
+	sha_final(&ctx, md);
+
+	free(data);
+	return 1;
+}
+
+/*
+ * Calculate the digest of a file. Regular files are mapped in memory and
+ * hashed in a single pass, and their digest is looked up in and added to the
+ * hash cache if it is enabled. This function may be called from several
+ * threads at the same time.
+ */
 int sha_file(int md_alg, const char *filename, unsigned char *md)
 {
-	FILE *inFile;
-	SHA256_CTX shaContext;
-	SHA512_CTX sha512Context;
-	int bytes;
-	unsigned char data[BUFFER_SIZE];
+	sha_cache_entry_t key;
+	struct stat st;
+	void *data;
+	int fd, ret = 1;
 
 	if ((filename == NULL) || (md == NULL)) {
 		ERROR("%s(): NULL argument\n", __FUNCTION__);
 		return 0;
 	}
 
-	inFile = fopen(filename, "rb");
-	if (inFile == NULL) {
+	fd = open(filename, O_RDONLY);
+	if (fd == -1) {
 		ERROR("Cannot read %s\n", filename);
 		return 0;
 	}
 
-	if (md_alg == HASH_ALG_SHA384) {
-		SHA384_Init(&sha512Context);
-		while ((bytes = fread(data, 1, BUFFER_SIZE, inFile)) != 0) {
-			SHA384_Update(&sha512Context, data, bytes);
+	if (fstat(fd, &st) == -1) {
+		ERROR("Cannot read %s\n", filename);
+		close(fd);
+		return 0;
+	}
+
+	if (!S_ISREG(st.st_mode)) {
+		/* Pipes and other special files can only be read once */
+		ret = sha_stream(md_alg, fd, md);
+	} else {
+		sha_cache_key(&key, md_alg, &st);
+		if (sha_cache_enabled && sha_cache_lookup(&key)) {
+			VERBOSE("Using cached hash of %s\n", filename);
+			memcpy(md, key.md, sha_md_len(md_alg));
+			close(fd);
+			return 1;
 		}
-		SHA384_Final(md, &sha512Context);
-	} else if (md_alg == HASH_ALG_SHA512) {
-		SHA512_Init(&sha512Context);
-		while ((bytes = fread(data, 1, BUFFER_SIZE, inFile)) != 0) {
-			SHA512_Update(&sha512Context, data, bytes);
+
+		data = MAP_FAILED;
+		if (st.st_size > 0) {
+			data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE,
+				    fd, 0);
 		}
-		SHA512_Final(md, &sha512Context);
-	} else {
-		SHA256_Init(&shaContext);
-		while ((bytes = fread(data, 1, BUFFER_SIZE, inFile)) != 0) {
-			SHA256_Update(&shaContext, data, bytes);
+		if (data != MAP_FAILED) {
+			sha_data(md_alg, data, st.st_size, md);
+			munmap(data, st.st_size);
+		} else {
+			ret = sha_stream(md_alg, fd, md);
 		}
-		SHA256_Final(md, &shaContext);
+
+		if (ret && sha_cache_enabled) {
+			memcpy(key.md, md, sha_md_len(md_alg));
+			sha_cache_update(&key);
+		}
+	}
+
+	if (!ret) {
+		ERROR("Cannot read %s\n", filename);
+	}
+
+	close(fd);
+	return ret;
+}
+
+/*
+ * Load the digests saved by a previous run in the hash cache file. A missing
+ * file is an empty cache, and a corrupted one is ignored.
+ */
+int sha_cache_load(const char *filename)
+{
+	sha_cache_entry_t entry;
+	char line[512], hex[2 * SHA512_DIGEST_LENGTH + 1];
+	unsigned int i, md_len;
+	FILE *file;
+
+	sha_cache_enabled = 1;
+
+	file = fopen(filename, "r");
+	if (file == NULL) {
+		return (errno == ENOENT);
+	}
+
+	if ((fgets(line, sizeof(line), file) == NULL) ||
+	    (strncmp(line, SHA_CACHE_HEADER "\n", sizeof(line)) != 0)) {
+		WARN("Ignoring hash cache %s\n", filename);
+		fclose(file);
+		return 1;
+	}
+
+	while (fgets(line, sizeof(line), file) != NULL) {
+		memset(&entry, 0, sizeof(entry));
+		if (sscanf(line, "%d %llu %llu %llu %lld %ld %lld %ld %128s",
+			   &entry.md_alg, &entry.dev, &entry.ino, &entry.size,
+			   &entry.mtime_sec, &entry.mtime_nsec,
+			   &entry.ctime_sec, &entry.ctime_nsec, hex) != 9) {
+			continue;
+		}
+
+		md_len = sha_md_len(entry.md_alg);
+		if (strlen(hex) != 2 * md_len) {
+			continue;
+		}
+		for (i = 0; i < md_len; i++) {
+			if (sscanf(&hex[2 * i], "%2hhx", &entry.md[i]) != 1) {
+				break;
+			}
+		}
+		if ((i != md_len) || (sha_cache_find(&entry) != NULL)) {
+			continue;
+		}
+
+		if (!sha_cache_add(&entry)) {
+			fclose(file);
+			return 0;
+		}
+	}
+
+	fclose(file);
+	return 1;
+}
+
+static void sha_cache_write_entry(FILE *file, const sha_cache_entry_t *entry)
+{
+	unsigned int i;
+
+	fprintf(file, "%d %llu %llu %llu %lld %ld %lld %ld ", entry->md_alg,
+		entry->dev, entry->ino, entry->size, entry->mtime_sec,
+		entry->mtime_nsec, entry->ctime_sec, entry->ctime_nsec);
+	for (i = 0; i < sha_md_len(entry->md_alg); i++) {
+		fprintf(file, "%02x", entry->md[i]);
+	}
+	fprintf(file, "\n");
+}
+
+/*
+ * Save the hash cache, keeping the digests used by this run first. The file is
+ * replaced atomically so that concurrent runs never read a partial cache.
+ */
+int sha_cache_save(const char *filename)
+{
+	char tmp_name[4096];
+	unsigned int i, num = 0;
+	int used;
+	FILE *file;
+
+	if (snprintf(tmp_name, sizeof(tmp_name), "%s.%ld", filename,
+		     (long)getpid()) >= sizeof(tmp_name)) {
+		return 0;
+	}
+
+	file = fopen(tmp_name, "w");
+	if (file == NULL) {
+		return 0;
+	}
+
+	fprintf(file, SHA_CACHE_HEADER "\n");
+	for (used = 1; used >= 0; used--) {
+		for (i = 0; i < sha_cache_num; i++) {
+			if ((sha_cache[i].used == used) &&
+			    (num < SHA_CACHE_MAX_ENTRIES)) {
+				sha_cache_write_entry(file, &sha_cache[i]);
+				num++;
+			}
+		}
+	}
+
+	if ((fclose(file) != 0) || (rename(tmp_name, filename) != 0)) {
+		remove(tmp_name);
+		return 0;
 	}
 
-	fclose(inFile);
 	return 1;
 }
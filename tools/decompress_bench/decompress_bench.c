@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2020, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Throughput benchmark of the decompressors of the image_decompress framework,
+ * gunzip() from lib/zlib and unlz4() from lib/lz4, built for the host. Each
+ * file given on the command line is decompressed with the decompressor of its
+ * format, in the same way as common/image_decompress.c does.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <tf_gunzip.h>
+#include <tf_unlz4.h>
+
+/* Workspace of the decompressors, as the rest of the platform buffer */
+#define WORK_SIZE	(1U << 20)
+/* Largest decompressed image */
+#define MAX_OUT_SIZE	(256U << 20)
+
+typedef int (decompressor_t)(uintptr_t *in_buf, size_t in_len,
+			     uintptr_t *out_buf, size_t out_len,
+			     uintptr_t work_buf, size_t work_len);
+
+static const struct {
+	const char *name;
+	const char *magic;
+	size_t magic_len;
+	decompressor_t *decompressor;
+} formats[] = {
+	{ "gzip", GZIP_MAGIC, GZIP_MAGIC_LEN, gunzip },
+	{ "lz4", LZ4_MAGIC, LZ4_MAGIC_LEN, unlz4 },
+};
+
+static unsigned long iterations = 20;
+
+static void *xmalloc(size_t size)
+{
+	void *p = malloc(size);
+
+	if (p == NULL) {
+		fprintf(stderr, "Out of memory\n");
+		exit(1);
+	}
+
+	return p;
+}
+
+static double now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static uint8_t *read_file(const char *filename, size_t *size)
+{
+	uint8_t *data;
+	FILE *fp;
+	long len;
+
+	fp = fopen(filename, "rb");
+	if (fp == NULL) {
+		perror(filename);
+		return NULL;
+	}
+
+	fseek(fp, 0, SEEK_END);
+	len = ftell(fp);
+	fseek(fp, 0, SEEK_SET);
+
+	data = xmalloc(len);
+	if (fread(data, 1, len, fp) != (size_t)len) {
+		perror(filename);
+		free(data);
+		data = NULL;
+	}
+
+	fclose(fp);
+	*size = len;
+	return data;
+}
+
+/* Decompress 'in' into 'out' and return the decompressed size, or 0 */
+static size_t decompress(decompressor_t *decompressor, const uint8_t *in,
+			 size_t in_len, uint8_t *out, uint8_t *work)
+{
+	uintptr_t in_buf = (uintptr_t)in;
+	uintptr_t out_buf = (uintptr_t)out;
+
+	if (decompressor(&in_buf, in_len, &out_buf, MAX_OUT_SIZE,
+			 (uintptr_t)work, WORK_SIZE) != 0)
+		return 0;
+
+	return out_buf - (uintptr_t)out;
+}
+
+static int bench_file(const char *filename, uint8_t *out, uint8_t *work)
+{
+	size_t in_len, out_len = 0, i;
+	unsigned long iter;
+	double start, ns;
+	uint8_t *in;
+
+	in = read_file(filename, &in_len);
+	if (in == NULL)
+		return 1;
+
+	for (i = 0; i < sizeof(formats) / sizeof(formats[0]); i++) {
+		if ((in_len >= formats[i].magic_len) &&
+		    (memcmp(in, formats[i].magic, formats[i].magic_len) == 0))
+			break;
+	}
+
+	if (i == sizeof(formats) / sizeof(formats[0])) {
+		fprintf(stderr, "%s: unknown compression format\n", filename);
+		free(in);
+		return 1;
+	}
+
+	/* The first run also warms up the caches */
+	out_len = decompress(formats[i].decompressor, in, in_len, out, work);
+	if (out_len == 0) {
+		fprintf(stderr, "%s: cannot decompress\n", filename);
+		free(in);
+		return 1;
+	}
+
+	start = now_ns();
+	for (iter = 0; iter < iterations; iter++)
+		decompress(formats[i].decompressor, in, in_len, out, work);
+	ns = (now_ns() - start) / iterations;
+
+	printf("%-5s %10zu -> %10zu bytes (%5.1f%%) %9.1f us %8.1f MB/s  %s\n",
+	       formats[i].name, in_len, out_len, 100.0 * in_len / out_len,
+	       ns / 1000, out_len * 1000 / ns, filename);
+
+	free(in);
+	return 0;
+}
+
+static void usage(void)
+{
+	printf("usage: decompress_bench [-n ITERATIONS] FILE...\n");
+	exit(1);
+}
+
+int main(int argc, char *argv[])
+{
+	uint8_t *out, *work;
+	char *end;
+	int opt, ret = 0;
+
+	while ((opt = getopt(argc, argv, "n:")) != -1) {
+		if (opt != 'n')
+			usage();
+		iterations = strtoul(optarg, &end, 0);
+		if ((*end != '\0') || (iterations == 0))
+			usage();
+	}
+
+	if (optind >= argc)
+		usage();
+
+	out = xmalloc(MAX_OUT_SIZE);
+	work = xmalloc(WORK_SIZE);
+
+	/* Fault the output buffer in, which the firmware doesn't have to do */
+	memset(out, 0, MAX_OUT_SIZE);
+
+	for (; optind < argc; optind++)
+		ret |= bench_file(argv[optind], out, work);
+
+	free(out);
+	free(work);
+	return ret;
+}
@@ -0,0 +1,17 @@
+/*
+ * Copyright (c) 2020, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/* Host replacement of include/common/debug.h for the decompressors */
+
+#ifndef DEBUG_H
+#define DEBUG_H
+
+#include <stdio.h>
+
+#define ERROR(...)	fprintf(stderr, "ERROR:   " __VA_ARGS__)
+#define VERBOSE(...)
+
+#endif /* DEBUG_H */
@@ -0,0 +1,14 @@
+/*
+ * Copyright (c) 2020, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/* Host replacement of include/lib/utils.h for the decompressors */
+
+#ifndef UTILS_H
+#define UTILS_H
+
+#include <lib/utils_def.h>
+
+#endif /* UTILS_H */
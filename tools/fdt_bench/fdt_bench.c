@@ -0,0 +1,331 @@
+/*
+ * Copyright (c) 2020, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Benchmark of the DTB lookups of common/fdt_wrappers.c, with and without the
+ * index built by fdtw_index_init(), over the DTB files given on the command
+ * line. Every lookup done through the index is checked against libfdt.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <libfdt.h>
+
+#include <common/debug.h>
+#include <common/fdt_wrappers.h>
+
+#define MAX_PATH_LEN	1024
+#define MAX_PROP_CELLS	256
+
+typedef struct prop {
+	int node;
+	const char *name;
+	unsigned int cells;
+} prop_t;
+
+typedef struct dtb_keys {
+	char **paths;
+	size_t nr_nodes;
+	const char **compats;
+	size_t nr_compats;
+	prop_t *props;
+	size_t nr_props;
+	size_t nr_index_keys;	/* Number of keys in the index */
+} dtb_keys_t;
+
+static unsigned long iterations = 100;
+
+size_t strlcpy(char *dst, const char *src, size_t dsize)
+{
+	size_t len = strlen(src);
+
+	if (dsize != 0U) {
+		size_t n = (len < dsize) ? len : (dsize - 1U);
+
+		memcpy(dst, src, n);
+		dst[n] = '\0';
+	}
+
+	return len;
+}
+
+static void *xmalloc(size_t size)
+{
+	void *p = malloc(size);
+
+	if (p == NULL) {
+		fprintf(stderr, "Out of memory\n");
+		exit(1);
+	}
+
+	return p;
+}
+
+static double now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static void *read_dtb(const char *filename)
+{
+	FILE *fp;
+	long size;
+	void *dtb;
+
+	fp = fopen(filename, "rb");
+	if (fp == NULL) {
+		perror(filename);
+		return NULL;
+	}
+
+	fseek(fp, 0, SEEK_END);
+	size = ftell(fp);
+	fseek(fp, 0, SEEK_SET);
+
+	dtb = xmalloc(size);
+	if (fread(dtb, 1, size, fp) != (size_t)size) {
+		perror(filename);
+		free(dtb);
+		dtb = NULL;
+	} else if ((fdt_check_header(dtb) != 0) ||
+		   (fdt_totalsize(dtb) > (uint32_t)size)) {
+		fprintf(stderr, "%s: not a valid DTB\n", filename);
+		free(dtb);
+		dtb = NULL;
+	}
+
+	fclose(fp);
+	return dtb;
+}
+
+/* List every node, compatible string and property of the DTB */
+static void collect_keys(const void *dtb, dtb_keys_t *keys)
+{
+	char path[MAX_PATH_LEN];
+	const char *name, *value;
+	int node, prop, len, depth = 0;
+	size_t i, nr_nodes = 0, nr_props = 0, nr_compats = 0;
+
+	for (node = 0; (node >= 0) && (depth >= 0);
+	     node = fdt_next_node(dtb, node, &depth)) {
+		nr_nodes++;
+		fdt_for_each_property_offset(prop, dtb, node) {
+			nr_props++;
+			value = fdt_getprop_by_offset(dtb, prop, &name, &len);
+			if (strcmp(name, "compatible") != 0)
+				continue;
+			for (i = 0; i < (size_t)len; i += strlen(value + i) + 1)
+				nr_compats++;
+		}
+	}
+
+	keys->paths = xmalloc(nr_nodes * sizeof(*keys->paths));
+	keys->props = xmalloc(nr_props * sizeof(*keys->props));
+	keys->compats = xmalloc(nr_compats * sizeof(*keys->compats));
+	keys->nr_nodes = keys->nr_props = keys->nr_compats = 0;
+	keys->nr_index_keys = nr_nodes + nr_props + nr_compats;
+
+	depth = 0;
+	for (node = 0; (node >= 0) && (depth >= 0);
+	     node = fdt_next_node(dtb, node, &depth)) {
+		if (fdt_get_path(dtb, node, path, sizeof(path)) == 0) {
+			keys->paths[keys->nr_nodes++] = strdup(path);
+		}
+
+		fdt_for_each_property_offset(prop, dtb, node) {
+			value = fdt_getprop_by_offset(dtb, prop, &name, &len);
+			if ((len % 4 == 0) && (len / 4 <= MAX_PROP_CELLS)) {
+				keys->props[keys->nr_props].node = node;
+				keys->props[keys->nr_props].name = name;
+				keys->props[keys->nr_props++].cells = len / 4;
+			}
+
+			if (strcmp(name, "compatible") != 0)
+				continue;
+			for (i = 0; i < (size_t)len; i += strlen(value + i) + 1)
+				keys->compats[keys->nr_compats++] = value + i;
+		}
+	}
+}
+
+/*
+ * Each lookup function runs all the lookups of one kind once, and returns a
+ * checksum of their results to compare the runs with and without the index.
+ */
+static unsigned long lookup_paths(const void *dtb, const dtb_keys_t *keys)
+{
+	unsigned long sum = 0;
+	size_t i;
+
+	/*
+	 * A path without unit addresses may match several nodes, so the node
+	 * found is not always the one the path was made from.
+	 */
+	for (i = 0; i < keys->nr_nodes; i++)
+		sum = sum * 31 + fdtw_path_offset(dtb, keys->paths[i]);
+
+	return sum;
+}
+
+static unsigned long lookup_compats(const void *dtb, const dtb_keys_t *keys)
+{
+	unsigned long sum = 0;
+	size_t i;
+	int node;
+
+	for (i = 0; i < keys->nr_compats; i++) {
+		node = fdtw_node_offset_by_compatible(dtb, -1,
+						      keys->compats[i]);
+		while (node >= 0) {
+			sum = sum * 31 + node;
+			node = fdtw_node_offset_by_compatible(dtb, node,
+							      keys->compats[i]);
+		}
+	}
+
+	return sum;
+}
+
+static unsigned long lookup_props(const void *dtb, const dtb_keys_t *keys)
+{
+	uint32_t cells[MAX_PROP_CELLS];
+	unsigned long sum = 0;
+	unsigned int j;
+	size_t i;
+
+	for (i = 0; i < keys->nr_props; i++) {
+		const prop_t *prop = &keys->props[i];
+
+		if (fdtw_read_array(dtb, prop->node, prop->name, prop->cells,
+				    cells) != 0) {
+			fprintf(stderr, "Cannot read %s\n", prop->name);
+			exit(1);
+		}
+		for (j = 0; j < prop->cells; j++)
+			sum = sum * 31 + cells[j];
+	}
+
+	return sum;
+}
+
+static void bench(const char *what, const void *dtb, const dtb_keys_t *keys,
+		  size_t nr, unsigned long (*lookup)(const void *dtb,
+						     const dtb_keys_t *keys),
+		  void *arena, size_t arena_size)
+{
+	unsigned long i, sum_fdt = 0, sum_index = 0;
+	double start, fdt_ns, index_ns;
+
+	if (nr == 0)
+		return;
+
+	fdtw_index_clear();
+	start = now_ns();
+	for (i = 0; i < iterations; i++)
+		sum_fdt = lookup(dtb, keys);
+	fdt_ns = (now_ns() - start) / (iterations * nr);
+
+	fdtw_index_init(dtb, arena, arena_size);
+	start = now_ns();
+	for (i = 0; i < iterations; i++)
+		sum_index = lookup(dtb, keys);
+	index_ns = (now_ns() - start) / (iterations * nr);
+
+	if (sum_fdt != sum_index) {
+		fprintf(stderr, "%s lookups differ with the index\n", what);
+		exit(1);
+	}
+
+	printf("  %-12s %8zu lookups  libfdt %9.1f ns  index %7.1f ns  x%.1f\n",
+	       what, nr, fdt_ns, index_ns, fdt_ns / index_ns);
+}
+
+static int bench_dtb(const char *filename)
+{
+	dtb_keys_t keys;
+	size_t i, arena_size;
+	double start, index_ns;
+	void *dtb, *arena;
+	int ret = 0;
+
+	dtb = read_dtb(filename);
+	if (dtb == NULL)
+		return 1;
+
+	collect_keys(dtb, &keys);
+
+	/* Large enough for all the keys, see fdtw_index_init() */
+	arena_size = 64 + 16 * keys.nr_index_keys;
+	arena = xmalloc(arena_size);
+
+	start = now_ns();
+	for (i = 0; i < iterations; i++) {
+		if (fdtw_index_init(dtb, arena, arena_size) != 0) {
+			fprintf(stderr, "%s: cannot index the DTB\n", filename);
+			ret = 1;
+			goto out;
+		}
+	}
+	index_ns = (now_ns() - start) / iterations;
+
+	printf("%s: %u bytes, %zu nodes, %zu properties, %zu compatibles\n",
+	       filename, fdt_totalsize(dtb), keys.nr_nodes, keys.nr_props,
+	       keys.nr_compats);
+	printf("  index        %8zu bytes    built in %.1f us\n", arena_size,
+	       index_ns / 1000);
+
+	bench("paths", dtb, &keys, keys.nr_nodes, lookup_paths, arena,
+	      arena_size);
+	bench("compatibles", dtb, &keys, keys.nr_compats, lookup_compats,
+	      arena, arena_size);
+	bench("properties", dtb, &keys, keys.nr_props, lookup_props, arena,
+	      arena_size);
+
+out:
+	fdtw_index_clear();
+	for (i = 0; i < keys.nr_nodes; i++)
+		free(keys.paths[i]);
+	free(keys.paths);
+	free(keys.props);
+	free(keys.compats);
+	free(arena);
+	free(dtb);
+	return ret;
+}
+
+static void usage(void)
+{
+	printf("usage: fdt_bench [-n ITERATIONS] DTB...\n");
+	exit(1);
+}
+
+int main(int argc, char *argv[])
+{
+	int i = 1, ret = 0;
+	char *end;
+
+	if ((argc > 2) && (strcmp(argv[1], "-n") == 0)) {
+		iterations = strtoul(argv[2], &end, 0);
+		if ((*end != '\0') || (iterations == 0))
+			usage();
+		i = 3;
+	}
+
+	if (i >= argc)
+		usage();
+
+	for (; i < argc; i++)
+		ret |= bench_dtb(argv[i]);
+
+	return ret;
+}
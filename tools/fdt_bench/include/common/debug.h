@@ -0,0 +1,21 @@
+/*
+ * Copyright (c) 2020, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/* Host replacement of include/common/debug.h for common/fdt_wrappers.c */
+
+#ifndef DEBUG_H
+#define DEBUG_H
+
+#include <stddef.h>
+#include <stdio.h>
+
+#define WARN(...)	fprintf(stderr, "WARNING: " __VA_ARGS__)
+#define VERBOSE(...)
+
+/* Provided by the firmware libc, but not by all host ones */
+size_t strlcpy(char *dst, const char *src, size_t dsize);
+
+#endif /* DEBUG_H */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2017, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2016-2020, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -36,6 +36,10 @@ static void remove_usage(void);
 static int version_cmd(int argc, char *argv[]);
 static void version_usage(void);
 static int help_cmd(int argc, char *argv[]);
+#ifndef _MSC_VER
+static int batch_cmd(int argc, char *argv[]);
+static void batch_usage(void);
+#endif
 static void usage(void);
 
 /* Available subcommands. */
@@ -47,12 +51,24 @@ static cmd_t cmds[] = {
 	{ .name = "remove",  .handler = remove_cmd,  .usage = remove_usage  },
 	{ .name = "version", .handler = version_cmd, .usage = version_usage },
 	{ .name = "help",    .handler = help_cmd,    .usage = NULL          },
+#ifndef _MSC_VER
+	{ .name = "batch",   .handler = batch_cmd,   .usage = batch_usage   },
+#endif
 };
 
 static image_desc_t *image_desc_head;
 static size_t nr_image_descs;
 static const uuid_t uuid_null;
 static int verbose;
+static unsigned long nr_jobs = 1;
+
+/* FIP parsed by parse_fip(), which the images of the image table point into */
+static void *fip_buf;
+static size_t fip_size;
+#ifndef _MSC_VER
+static dev_t fip_dev;
+static ino_t fip_ino;
+#endif
 
 static void vlog(int prio, const char *msg, va_list ap)
 {
@@ -128,12 +144,211 @@ static void *xzalloc(size_t size, const char *msg)
 	return memset(xmalloc(size, msg), 0, size);
 }
 
-static void xfwrite(void *buf, size_t size, FILE *fp, const char *filename)
+#ifndef _MSC_VER
+typedef int out_file_t;
+
+/*
+ * Map a whole file read-only. Empty files can't be mapped and are returned as a
+ * NULL buffer.
+ */
+static void *map_file(const char *filename, size_t *size)
+{
+	struct BLD_PLAT_STAT st;
+	void *buf = NULL;
+	int fd;
+
+	fd = open(filename, O_RDONLY);
+	if (fd == -1)
+		log_err("open %s", filename);
+
+	if (fstat(fd, &st) == -1)
+		log_err("fstat %s", filename);
+
+	*size = st.st_size;
+	if (*size != 0) {
+		buf = mmap(NULL, *size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (buf == MAP_FAILED)
+			log_err("mmap %s", filename);
+	}
+	close(fd);
+	return buf;
+}
+
+static void unmap_file(void *buf, size_t size)
+{
+	if (buf != NULL)
+		munmap(buf, size);
+}
+
+static out_file_t open_out_file(const char *filename)
+{
+	struct BLD_PLAT_STAT st;
+	int fd;
+
+	/*
+	 * Truncating the parsed FIP would pull its images from under their
+	 * mapping, so write a new file in its place instead.
+	 */
+	if (fip_buf != NULL && stat(filename, &st) == 0 &&
+	    st.st_dev == fip_dev && st.st_ino == fip_ino &&
+	    unlink(filename) == -1)
+		log_err("unlink %s", filename);
+
+	fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+	if (fd == -1)
+		log_err("open %s", filename);
+	return fd;
+}
+
+/* This can be called from several threads at once. */
+static void write_out_file(out_file_t fd, const void *buf, size_t size,
+    uint64_t offset, const char *filename)
+{
+	const char *p = buf;
+
+	while (size > 0) {
+		ssize_t ret = pwrite(fd, p, size, offset);
+
+		if (ret == -1) {
+			if (errno == EINTR)
+				continue;
+			log_err("pwrite %s", filename);
+		}
+		p += ret;
+		size -= ret;
+		offset += ret;
+	}
+}
+
+/*
+ * Set the size of the file and close it. The end of the file and the gaps
+ * between the writes are left as holes, which read as zeros.
+ */
+static void close_out_file(out_file_t fd, uint64_t size, const char *filename)
+{
+	if (ftruncate(fd, size) == -1)
+		log_err("ftruncate %s", filename);
+	if (close(fd) == -1)
+		log_err("close %s", filename);
+}
+#else
+typedef FILE *out_file_t;
+
+static void *map_file(const char *filename, size_t *size)
+{
+	struct BLD_PLAT_STAT st;
+	void *buf = NULL;
+	FILE *fp;
+
+	fp = fopen(filename, "rb");
+	if (fp == NULL)
+		log_err("fopen %s", filename);
+
+	if (fstat(fileno(fp), &st) == -1)
+		log_err("fstat %s", filename);
+
+	*size = st.st_size;
+	if (*size != 0) {
+		buf = xmalloc(*size, "failed to load file into memory");
+		if (fread(buf, 1, *size, fp) != *size)
+			log_errx("Failed to read %s", filename);
+	}
+	fclose(fp);
+	return buf;
+}
+
+static void unmap_file(void *buf, size_t size)
+{
+	free(buf);
+}
+
+static out_file_t open_out_file(const char *filename)
+{
+	FILE *fp;
+
+	fp = fopen(filename, "wb");
+	if (fp == NULL)
+		log_err("fopen %s", filename);
+	return fp;
+}
+
+static void write_out_file(out_file_t fp, const void *buf, size_t size,
+    uint64_t offset, const char *filename)
 {
+	if (fseek(fp, offset, SEEK_SET))
+		log_errx("Failed to set file position");
 	if (fwrite(buf, 1, size, fp) != size)
 		log_errx("Failed to write %s", filename);
 }
 
+static void close_out_file(out_file_t fp, uint64_t size, const char *filename)
+{
+	long pos;
+
+	if (fseek(fp, 0, SEEK_END) || (pos = ftell(fp)) < 0)
+		log_errx("Failed to set file position");
+	for (; (uint64_t)pos < size; pos++)
+		fputc(0x0, fp);
+	fclose(fp);
+}
+#endif
+
+#ifndef _MSC_VER
+typedef struct parallel_work {
+	void           (*fn)(size_t idx, void *arg);
+	void            *arg;
+	size_t           nr;
+	size_t           next;
+	pthread_mutex_t  lock;
+} parallel_work_t;
+
+static void *parallel_worker(void *data)
+{
+	parallel_work_t *work = data;
+	size_t idx;
+
+	for (;;) {
+		pthread_mutex_lock(&work->lock);
+		idx = work->next++;
+		pthread_mutex_unlock(&work->lock);
+
+		if (idx >= work->nr)
+			return NULL;
+		work->fn(idx, work->arg);
+	}
+}
+#endif
+
+/* Call fn(idx, arg) for each idx lower than nr, on up to nr_jobs threads. */
+static void run_parallel(size_t nr, void (*fn)(size_t idx, void *arg),
+    void *arg)
+{
+	size_t i;
+#ifndef _MSC_VER
+	size_t nr_threads = nr < nr_jobs ? nr : nr_jobs;
+
+	if (nr_threads > 1) {
+		parallel_work_t work = { .fn = fn, .arg = arg, .nr = nr };
+		pthread_t *threads;
+
+		threads = xmalloc(nr_threads * sizeof(*threads),
+		    "failed to allocate memory for threads");
+		pthread_mutex_init(&work.lock, NULL);
+		for (i = 0; i < nr_threads; i++)
+			if (pthread_create(&threads[i], NULL, parallel_worker,
+			    &work) != 0)
+				log_errx("Failed to create thread");
+		for (i = 0; i < nr_threads; i++)
+			pthread_join(threads[i], NULL);
+		pthread_mutex_destroy(&work.lock);
+		free(threads);
+		return;
+	}
+#endif
+	for (i = 0; i < nr; i++)
+		fn(i, arg);
+}
+
 static image_desc_t *new_image_desc(const uuid_t *uuid,
     const char *name, const char *cmdline_name)
 {
@@ -164,15 +379,20 @@ static void set_image_desc_action(image_desc_t *desc, int action,
 		    "failed to allocate memory for argument");
 }
 
+static void free_image(image_t *image)
+{
+	if (!image->in_fip)
+		unmap_file(image->buffer, image->toc_e.size);
+	free(image);
+}
+
 static void free_image_desc(image_desc_t *desc)
 {
 	free(desc->name);
 	free(desc->cmdline_name);
 	free(desc->action_arg);
-	if (desc->image) {
-		free(desc->image->buffer);
-		free(desc->image);
-	}
+	if (desc->image)
+		free_image(desc->image);
 	free(desc);
 }
 
@@ -199,6 +419,9 @@ static void free_image_descs(void)
 		nr_image_descs--;
 	}
 	assert(nr_image_descs == 0);
+
+	unmap_file(fip_buf, fip_size);
+	fip_buf = NULL;
 }
 
 static void fill_image_descs(void)
@@ -280,28 +503,19 @@ static void uuid_from_str(uuid_t *u, const char *s)
 
 static int parse_fip(const char *filename, fip_toc_header_t *toc_header_out)
 {
-	struct BLD_PLAT_STAT st;
-	FILE *fp;
 	char *buf, *bufend;
+	size_t size;
 	fip_toc_header_t *toc_header;
 	fip_toc_entry_t *toc_entry;
 	int terminated = 0;
+#ifndef _MSC_VER
+	struct BLD_PLAT_STAT st;
+#endif
 
-	fp = fopen(filename, "rb");
-	if (fp == NULL)
-		log_err("fopen %s", filename);
-
-	if (fstat(fileno(fp), &st) == -1)
-		log_err("fstat %s", filename);
-
-	buf = xmalloc(st.st_size, "failed to load file into memory");
-	if (fread(buf, 1, st.st_size, fp) != st.st_size)
-		log_errx("Failed to read %s", filename);
-	bufend = buf + st.st_size;
-	fclose(fp);
-
-	if (st.st_size < sizeof(fip_toc_header_t))
+	buf = map_file(filename, &size);
+	if (size < sizeof(fip_toc_header_t))
 		log_errx("FIP %s is truncated", filename);
+	bufend = buf + size;
 
 	toc_header = (fip_toc_header_t *)buf;
 	toc_entry = (fip_toc_entry_t *)(toc_header + 1);
@@ -331,16 +545,14 @@ static int parse_fip(const char *filename, fip_toc_header_t *toc_header_out)
 		image = xzalloc(sizeof(*image),
 		    "failed to allocate memory for image");
 		image->toc_e = *toc_entry;
-		image->buffer = xmalloc(toc_entry->size,
-		    "failed to allocate image buffer, is FIP file corrupted?");
-		/* Overflow checks before memory copy. */
+		/* Overflow checks before pointing into the FIP. */
 		if (toc_entry->size > (uint64_t)-1 - toc_entry->offset_address)
 			log_errx("FIP %s is corrupted", filename);
-		if (toc_entry->size + toc_entry->offset_address > st.st_size)
+		if (toc_entry->size + toc_entry->offset_address > size)
 			log_errx("FIP %s is corrupted", filename);
 
-		memcpy(image->buffer, buf + toc_entry->offset_address,
-		    toc_entry->size);
+		image->buffer = buf + toc_entry->offset_address;
+		image->in_fip = 1;
 
 		/* If this is an unknown image, create a descriptor for it. */
 		desc = lookup_image_desc_from_uuid(&toc_entry->uuid);
@@ -366,46 +578,43 @@ static int parse_fip(const char *filename, fip_toc_header_t *toc_header_out)
 	if (terminated == 0)
 		log_errx("FIP %s does not have a ToC terminator entry",
 		    filename);
-	free(buf);
+
+	/* The images point into the FIP, keep it until free_image_descs(). */
+	assert(fip_buf == NULL);
+	fip_buf = buf;
+	fip_size = size;
+#ifndef _MSC_VER
+	if (stat(filename, &st) == -1)
+		log_err("stat %s", filename);
+	fip_dev = st.st_dev;
+	fip_ino = st.st_ino;
+#endif
 	return 0;
 }
 
 static image_t *read_image_from_file(const uuid_t *uuid, const char *filename)
 {
-	struct BLD_PLAT_STAT st;
 	image_t *image;
-	FILE *fp;
+	size_t size;
 
 	assert(uuid != NULL);
 	assert(filename != NULL);
 
-	fp = fopen(filename, "rb");
-	if (fp == NULL)
-		log_err("fopen %s", filename);
-
-	if (fstat(fileno(fp), &st) == -1)
-		log_errx("fstat %s", filename);
-
 	image = xzalloc(sizeof(*image), "failed to allocate memory for image");
 	image->toc_e.uuid = *uuid;
-	image->buffer = xmalloc(st.st_size, "failed to allocate image buffer");
-	if (fread(image->buffer, 1, st.st_size, fp) != st.st_size)
-		log_errx("Failed to read %s", filename);
-	image->toc_e.size = st.st_size;
+	image->buffer = map_file(filename, &size);
+	image->toc_e.size = size;
 
-	fclose(fp);
 	return image;
 }
 
 static int write_image_to_file(const image_t *image, const char *filename)
 {
-	FILE *fp;
+	out_file_t out;
 
-	fp = fopen(filename, "wb");
-	if (fp == NULL)
-		log_err("fopen");
-	xfwrite(image->buffer, image->toc_e.size, fp, filename);
-	fclose(fp);
+	out = open_out_file(filename);
+	write_out_file(out, image->buffer, image->toc_e.size, 0, filename);
+	close_out_file(out, image->toc_e.size, filename);
 	return 0;
 }
 
@@ -442,10 +651,28 @@ static void md_print(const unsigned char *md, size_t len)
 		printf("%02x", md[i]);
 }
 
+#ifndef _MSC_VER	/* We don't have SHA256 for Visual Studio. */
+typedef struct hash_job {
+	const image_t *image;
+	unsigned char  md[SHA256_DIGEST_LENGTH];
+} hash_job_t;
+
+static void hash_image(size_t idx, void *arg)
+{
+	hash_job_t *job = (hash_job_t *)arg + idx;
+
+	SHA256(job->image->buffer, job->image->toc_e.size, job->md);
+}
+#endif
+
 static int info_cmd(int argc, char *argv[])
 {
 	image_desc_t *desc;
 	fip_toc_header_t toc_header;
+#ifndef _MSC_VER
+	hash_job_t *jobs = NULL;
+	size_t hash_idx = 0, nr_images = 0;
+#endif
 
 	if (argc != 2)
 		info_usage();
@@ -462,6 +689,18 @@ static int info_cmd(int argc, char *argv[])
 		    (unsigned long long)toc_header.flags);
 	}
 
+#ifndef _MSC_VER
+	/* Hash all the images in parallel before printing them in order. */
+	if (verbose) {
+		jobs = xzalloc(nr_image_descs * sizeof(*jobs),
+		    "failed to allocate memory for hashes");
+		for (desc = image_desc_head; desc != NULL; desc = desc->next)
+			if (desc->image != NULL)
+				jobs[nr_images++].image = desc->image;
+		run_parallel(nr_images, hash_image, jobs);
+	}
+#endif
+
 	for (desc = image_desc_head; desc != NULL; desc = desc->next) {
 		image_t *image = desc->image;
 
@@ -474,16 +713,18 @@ static int info_cmd(int argc, char *argv[])
 		       desc->cmdline_name);
 #ifndef _MSC_VER	/* We don't have SHA256 for Visual Studio. */
 		if (verbose) {
-			unsigned char md[SHA256_DIGEST_LENGTH];
+			hash_job_t *job = &jobs[hash_idx++];
 
-			SHA256(image->buffer, image->toc_e.size, md);
 			printf(", sha256=");
-			md_print(md, sizeof(md));
+			md_print(job->md, sizeof(job->md));
 		}
 #endif
 		putchar('\n');
 	}
 
+#ifndef _MSC_VER
+	free(jobs);
+#endif
 	return 0;
 }
 
@@ -493,14 +734,29 @@ static void info_usage(void)
 	exit(1);
 }
 
+typedef struct pack_job {
+	out_file_t      out;
+	const char     *filename;
+	const image_t **images;
+} pack_job_t;
+
+static void pack_image(size_t idx, void *arg)
+{
+	pack_job_t *job = arg;
+	const image_t *image = job->images[idx];
+
+	write_out_file(job->out, image->buffer, image->toc_e.size,
+	    image->toc_e.offset_address, job->filename);
+}
+
 static int pack_images(const char *filename, uint64_t toc_flags, unsigned long align)
 {
-	FILE *fp;
+	pack_job_t job = { .filename = filename };
 	image_desc_t *desc;
 	fip_toc_header_t *toc_header;
 	fip_toc_entry_t *toc_entry;
 	char *buf;
-	uint64_t entry_offset, buf_size, payload_size = 0, pad_size;
+	uint64_t entry_offset, buf_size, payload_size = 0;
 	size_t nr_images = 0;
 
 	for (desc = image_desc_head; desc != NULL; desc = desc->next)
@@ -543,38 +799,30 @@ static int pack_images(const char *filename, uint64_t toc_flags, unsigned long a
 	toc_entry->offset_address = (entry_offset + align - 1) & ~(align - 1);
 
 	/* Generate the FIP file. */
-	fp = fopen(filename, "wb");
-	if (fp == NULL)
-		log_err("fopen %s", filename);
+	job.out = open_out_file(filename);
 
 	if (verbose)
 		log_dbgx("Metadata size: %zu bytes", buf_size);
 
-	xfwrite(buf, buf_size, fp, filename);
+	write_out_file(job.out, buf, buf_size, 0, filename);
 
 	if (verbose)
 		log_dbgx("Payload size: %zu bytes", payload_size);
 
-	for (desc = image_desc_head; desc != NULL; desc = desc->next) {
-		image_t *image = desc->image;
-
-		if (image == NULL)
-			continue;
-		if (fseek(fp, image->toc_e.offset_address, SEEK_SET))
-			log_errx("Failed to set file position");
-
-		xfwrite(image->buffer, image->toc_e.size, fp, filename);
-	}
-
-	if (fseek(fp, entry_offset, SEEK_SET))
-		log_errx("Failed to set file position");
+	/* Each image is written at its own offset, so in parallel. */
+	job.images = xmalloc((nr_images + 1) * sizeof(*job.images),
+	    "failed to allocate memory for image list");
+	nr_images = 0;
+	for (desc = image_desc_head; desc != NULL; desc = desc->next)
+		if (desc->image != NULL)
+			job.images[nr_images++] = desc->image;
+	run_parallel(nr_images, pack_image, &job);
 
-	pad_size = toc_entry->offset_address - entry_offset;
-	while (pad_size--)
-		fputc(0x0, fp);
+	/* Pad the FIP with zeros up to the end of the last entry. */
+	close_out_file(job.out, toc_entry->offset_address, filename);
 
+	free(job.images);
 	free(buf);
-	fclose(fp);
 	return 0;
 }
 
@@ -604,7 +852,7 @@ static void update_fip(void)
 				    desc->cmdline_name,
 				    desc->action_arg);
 			}
-			free(desc->image);
+			free_image(desc->image);
 			desc->image = image;
 		} else {
 			if (verbose)
@@ -870,11 +1118,24 @@ static void update_usage(void)
 	exit(1);
 }
 
+typedef struct unpack_job {
+	const image_t *image;
+	char           file[PATH_MAX];
+} unpack_job_t;
+
+static void unpack_image(size_t idx, void *arg)
+{
+	unpack_job_t *job = (unpack_job_t *)arg + idx;
+
+	write_image_to_file(job->image, job->file);
+}
+
 static int unpack_cmd(int argc, char *argv[])
 {
 	struct option *opts = NULL;
-	size_t nr_opts = 0;
+	size_t nr_opts = 0, nr_images = 0;
 	char outdir[PATH_MAX] = { 0 };
+	unpack_job_t *jobs;
 	image_desc_t *desc;
 	int fflag = 0;
 	int unpack_all = 1;
@@ -950,9 +1211,12 @@ static int unpack_cmd(int argc, char *argv[])
 		if (chdir(outdir) == -1)
 			log_err("chdir %s", outdir);
 
+	jobs = xmalloc(nr_image_descs * sizeof(*jobs),
+	    "failed to allocate memory for image list");
+
 	/* Unpack all specified images. */
 	for (desc = image_desc_head; desc != NULL; desc = desc->next) {
-		char file[PATH_MAX];
+		char *file = jobs[nr_images].file;
 		image_t *image = desc->image;
 
 		if (!unpack_all && desc->action != DO_UNPACK)
@@ -960,10 +1224,10 @@ static int unpack_cmd(int argc, char *argv[])
 
 		/* Build filename. */
 		if (desc->action_arg == NULL)
-			snprintf(file, sizeof(file), "%s.bin",
+			snprintf(file, PATH_MAX, "%s.bin",
 			    desc->cmdline_name);
 		else
-			snprintf(file, sizeof(file), "%s",
+			snprintf(file, PATH_MAX, "%s",
 			    desc->action_arg);
 
 		if (image == NULL) {
@@ -976,13 +1240,15 @@ static int unpack_cmd(int argc, char *argv[])
 		if (access(file, F_OK) != 0 || fflag) {
 			if (verbose)
 				log_dbgx("Unpacking %s", file);
-			write_image_to_file(image, file);
+			jobs[nr_images++].image = image;
 		} else {
 			log_warnx("File %s already exists, use --force to overwrite it",
 			    file);
 		}
 	}
 
+	run_parallel(nr_images, unpack_image, jobs);
+	free(jobs);
 	return 0;
 }
 
@@ -1098,7 +1364,7 @@ static int remove_cmd(int argc, char *argv[])
 			if (verbose)
 				log_dbgx("Removing %s",
 				    desc->cmdline_name);
-			free(desc->image);
+			free_image(desc->image);
 			desc->image = NULL;
 		} else {
 			log_warnx("%s does not exist in %s",
@@ -1164,11 +1430,207 @@ static int help_cmd(int argc, char *argv[])
 	return 0;
 }
 
+static cmd_t *lookup_cmd(const char *name)
+{
+	int i;
+
+	for (i = 0; i < NELEM(cmds); i++)
+		if (strcmp(cmds[i].name, name) == 0)
+			return &cmds[i];
+	return NULL;
+}
+
+#ifndef _MSC_VER
+/* The arguments of a manifest line, copied out of the manifest. */
+typedef struct batch_line {
+	char **args;
+	size_t nr_args;
+	unsigned long lineno;
+} batch_line_t;
+
+/*
+ * Read all the command lines of the manifest, so that no stream is left open
+ * while the commands run. The exit() of a child would otherwise flush the
+ * stream it inherited and move the shared file offset, making the parent
+ * read some lines again.
+ */
+static batch_line_t *read_batch_manifest(const char *filename,
+    size_t *nr_lines)
+{
+	char *line = NULL, *p;
+	size_t line_size = 0, nr_lines_max = 0, nr_args_max;
+	unsigned long lineno = 0;
+	batch_line_t *lines = NULL, *bl;
+	FILE *fp;
+
+	fp = fopen(filename, "r");
+	if (fp == NULL)
+		log_err("fopen %s", filename);
+
+	*nr_lines = 0;
+	while (getline(&line, &line_size, fp) != -1) {
+		lineno++;
+
+		if (*nr_lines == nr_lines_max) {
+			nr_lines_max = nr_lines_max * 2 + 8;
+			lines = realloc(lines, nr_lines_max * sizeof(*lines));
+			if (lines == NULL)
+				log_err("realloc");
+		}
+		bl = &lines[*nr_lines];
+		bl->args = NULL;
+		bl->nr_args = 0;
+		bl->lineno = lineno;
+		nr_args_max = 0;
+
+		/* Split the line into arguments, up to an eventual comment. */
+		for (p = strtok(line, " \t\r\n"); p != NULL && *p != '#';
+		     p = strtok(NULL, " \t\r\n")) {
+			if (bl->nr_args + 1 >= nr_args_max) {
+				nr_args_max = nr_args_max * 2 + 8;
+				bl->args = realloc(bl->args,
+				    nr_args_max * sizeof(*bl->args));
+				if (bl->args == NULL)
+					log_err("realloc");
+			}
+			bl->args[bl->nr_args++] = xstrdup(p, "batch argument");
+		}
+		if (bl->nr_args == 0)
+			continue;
+		bl->args[bl->nr_args] = NULL;
+
+		if (lookup_cmd(bl->args[0]) == NULL ||
+		    strcmp(bl->args[0], "batch") == 0)
+			log_errx("%s:%lu: Invalid command %s", filename,
+			    lineno, bl->args[0]);
+		(*nr_lines)++;
+	}
+
+	free(line);
+	fclose(fp);
+	return lines;
+}
+
+static void free_batch_manifest(batch_line_t *lines, size_t nr_lines)
+{
+	size_t i, j;
+
+	for (i = 0; i < nr_lines; i++) {
+		for (j = 0; j < lines[i].nr_args; j++)
+			free(lines[i].args[j]);
+		free(lines[i].args);
+	}
+	free(lines);
+}
+
+/*
+ * Run the command of a manifest line in a child process, so that it starts
+ * with a fresh image table and working directory, and can run in parallel
+ * with the other lines.
+ */
+static void spawn_batch_cmd(int argc, char *argv[])
+{
+	pid_t pid;
+	int ret;
+
+	fflush(stdout);
+	fflush(stderr);
+	pid = fork();
+	if (pid == -1)
+		log_err("fork");
+	if (pid != 0)
+		return;
+
+	/* Don't run nr_jobs threads in each of the nr_jobs processes. */
+	nr_jobs = 1;
+	optind = 0;
+	ret = lookup_cmd(argv[0])->handler(argc, argv);
+
+	/*
+	 * Leave without running the exit handlers inherited from the parent.
+	 * The error paths of the command still exit(), which is harmless as
+	 * the only streams left are stdout and stderr, flushed before the fork.
+	 */
+	fflush(stdout);
+	fflush(stderr);
+	_exit(ret);
+}
+
+static int wait_batch_cmd(void)
+{
+	int status;
+
+	if (wait(&status) == -1)
+		log_err("wait");
+	return !WIFEXITED(status) || WEXITSTATUS(status) != 0;
+}
+
+static int batch_cmd(int argc, char *argv[])
+{
+	unsigned long running = 0;
+	batch_line_t *lines;
+	size_t nr_lines, i;
+	int failed = 0;
+
+	if (argc != 2)
+		batch_usage();
+
+	lines = read_batch_manifest(argv[1], &nr_lines);
+
+	for (i = 0; i < nr_lines; i++) {
+		if (running == nr_jobs) {
+			failed += wait_batch_cmd();
+			running--;
+		}
+		if (verbose)
+			log_dbgx("Running line %lu of %s", lines[i].lineno,
+			    argv[1]);
+		spawn_batch_cmd(lines[i].nr_args, lines[i].args);
+		running++;
+	}
+
+	while (running-- > 0)
+		failed += wait_batch_cmd();
+
+	free_batch_manifest(lines, nr_lines);
+
+	if (failed != 0)
+		log_errx("%d command(s) of %s failed", failed, argv[1]);
+	return 0;
+}
+
+static void batch_usage(void)
+{
+	printf("fiptool batch MANIFEST_FILENAME\n");
+	printf("\n");
+	printf("Run the fiptool commands listed in the manifest, one per line, without\n");
+	printf("the leading \"fiptool\" (e.g. \"create --soc-fw bl31.bin fip.bin\").\n");
+	printf("Arguments are separated by blanks, and '#' starts a comment. Up to\n");
+	printf("--jobs commands run at the same time, so they must not depend on each\n");
+	printf("other's output.\n");
+	exit(1);
+}
+#endif
+
+static unsigned long get_nr_jobs(const char *arg)
+{
+	char *endptr;
+	unsigned long jobs;
+
+	errno = 0;
+	jobs = strtoul(arg, &endptr, 0);
+	if (*endptr != '\0' || jobs == 0 || errno != 0)
+		log_errx("Invalid number of jobs: %s", arg);
+
+	return jobs;
+}
+
 static void usage(void)
 {
-	printf("usage: fiptool [--verbose] <command> [<args>]\n");
+	printf("usage: fiptool [--verbose] [--jobs N] <command> [<args>]\n");
 	printf("Global options supported:\n");
 	printf("  --verbose\tEnable verbose output for all commands.\n");
+	printf("  --jobs N\tUse up to N threads or processes (default: number of CPUs).\n");
 	printf("\n");
 	printf("Commands supported:\n");
 	printf("  info\t\tList images contained in FIP.\n");
@@ -1178,17 +1640,27 @@ static void usage(void)
 	printf("  remove\tRemove images from FIP.\n");
 	printf("  version\tShow fiptool version.\n");
 	printf("  help\t\tShow help for given command.\n");
+#ifndef _MSC_VER
+	printf("  batch\t\tRun the commands listed in a manifest file.\n");
+#endif
 	exit(1);
 }
 
 int main(int argc, char *argv[])
 {
-	int i, ret = 0;
+	cmd_t *cmd;
+	int ret = 0;
+
+#ifndef _MSC_VER
+	if (sysconf(_SC_NPROCESSORS_ONLN) > 1)
+		nr_jobs = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
 
 	while (1) {
 		int c, opt_index = 0;
 		static struct option opts[] = {
 			{ "verbose", no_argument, NULL, 'v' },
+			{ "jobs", required_argument, NULL, 'j' },
 			{ NULL, no_argument, NULL, 0 }
 		};
 
@@ -1196,7 +1668,7 @@ int main(int argc, char *argv[])
 		 * Set POSIX mode so getopt stops at the first non-option
 		 * which is the subcommand.
 		 */
-		c = getopt_long(argc, argv, "+v", opts, &opt_index);
+		c = getopt_long(argc, argv, "+vj:", opts, &opt_index);
 		if (c == -1)
 			break;
 
@@ -1204,6 +1676,9 @@ int main(int argc, char *argv[])
 		case 'v':
 			verbose = 1;
 			break;
+		case 'j':
+			nr_jobs = get_nr_jobs(optarg);
+			break;
 		default:
 			usage();
 		}
@@ -1217,14 +1692,10 @@ int main(int argc, char *argv[])
 		usage();
 
 	fill_image_descs();
-	for (i = 0; i < NELEM(cmds); i++) {
-		if (strcmp(cmds[i].name, argv[0]) == 0) {
-			ret = cmds[i].handler(argc, argv);
-			break;
-		}
-	}
-	if (i == NELEM(cmds))
+	cmd = lookup_cmd(argv[0]);
+	if (cmd == NULL)
 		usage();
+	ret = cmd->handler(argc, argv);
 	free_image_descs();
 	return ret;
 }
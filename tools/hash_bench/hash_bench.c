@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2020, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Throughput benchmark of the hash functions of mbed TLS, built for the host
+ * with the configuration used by the firmware. Each algorithm hashes a buffer
+ * in one call, as verify_hash() in drivers/auth/mbedtls/mbedtls_crypto.c does,
+ * and in chunks, as the incremental hash used while images are loaded does.
+ * Both digests are checked to be equal.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <mbedtls/md.h>
+#include <mbedtls/platform.h>
+
+static size_t data_size = 16U * 1024U * 1024U;
+static size_t chunk_size = 64U * 1024U;
+static unsigned long iterations = 10;
+
+/* SHA-256 digest of "abc", from FIPS 180-2 */
+static const uint8_t sha256_abc[] = {
+	0xba, 0x78, 0x16, 0xbf, 0x8f, 0x01, 0xcf, 0xea,
+	0x41, 0x41, 0x40, 0xde, 0x5d, 0xae, 0x22, 0x23,
+	0xb0, 0x03, 0x61, 0xa3, 0x96, 0x17, 0x7a, 0x9c,
+	0xb4, 0x10, 0xff, 0x61, 0xf2, 0x00, 0x15, 0xad,
+};
+
+static const mbedtls_md_type_t algs[] = {
+	MBEDTLS_MD_SHA256, MBEDTLS_MD_SHA384, MBEDTLS_MD_SHA512,
+};
+
+static void *xmalloc(size_t size)
+{
+	void *p = malloc(size);
+
+	if (p == NULL) {
+		fprintf(stderr, "Out of memory\n");
+		exit(1);
+	}
+
+	return p;
+}
+
+static double now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static void hash_whole(const mbedtls_md_info_t *info, const uint8_t *data,
+		       uint8_t *out)
+{
+	if (mbedtls_md(info, data, data_size, out) != 0) {
+		fprintf(stderr, "%s failed\n", mbedtls_md_get_name(info));
+		exit(1);
+	}
+}
+
+static void hash_chunks(const mbedtls_md_info_t *info, const uint8_t *data,
+			uint8_t *out)
+{
+	mbedtls_md_context_t ctx;
+	size_t offset, len;
+	int rc;
+
+	mbedtls_md_init(&ctx);
+	rc = mbedtls_md_setup(&ctx, info, 0);
+	if (rc == 0)
+		rc = mbedtls_md_starts(&ctx);
+
+	for (offset = 0U; (rc == 0) && (offset < data_size); offset += len) {
+		len = data_size - offset;
+		if (len > chunk_size)
+			len = chunk_size;
+
+		rc = mbedtls_md_update(&ctx, data + offset, len);
+	}
+
+	if (rc == 0)
+		rc = mbedtls_md_finish(&ctx, out);
+	mbedtls_md_free(&ctx);
+
+	if (rc != 0) {
+		fprintf(stderr, "%s failed\n", mbedtls_md_get_name(info));
+		exit(1);
+	}
+}
+
+/* Return the throughput in MB/s of 'hash' */
+static double bench(const mbedtls_md_info_t *info, const uint8_t *data,
+		    uint8_t *out,
+		    void (*hash)(const mbedtls_md_info_t *info,
+				 const uint8_t *data, uint8_t *out))
+{
+	unsigned long i;
+	double start;
+
+	/* Warm up the caches and the CPU clock */
+	hash(info, data, out);
+
+	start = now_ns();
+	for (i = 0; i < iterations; i++)
+		hash(info, data, out);
+
+	return (double)data_size * iterations * 1000 / (now_ns() - start);
+}
+
+static void usage(void)
+{
+	printf("usage: hash_bench [-n ITERATIONS] [-s SIZE_KB] [-c CHUNK_KB]\n");
+	exit(1);
+}
+
+static unsigned long parse_number(const char *arg)
+{
+	unsigned long val;
+	char *end;
+
+	val = strtoul(arg, &end, 0);
+	if ((*end != '\0') || (val == 0))
+		usage();
+
+	return val;
+}
+
+int main(int argc, char *argv[])
+{
+	uint8_t whole[MBEDTLS_MD_MAX_SIZE], chunks[MBEDTLS_MD_MAX_SIZE];
+	const mbedtls_md_info_t *info;
+	double whole_mbs, chunks_mbs;
+	uint8_t *data;
+	size_t i;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "n:s:c:")) != -1) {
+		switch (opt) {
+		case 'n':
+			iterations = parse_number(optarg);
+			break;
+		case 's':
+			data_size = parse_number(optarg) * 1024U;
+			break;
+		case 'c':
+			chunk_size = parse_number(optarg) * 1024U;
+			break;
+		default:
+			usage();
+		}
+	}
+
+	if (optind != argc)
+		usage();
+
+#ifdef MBEDTLS_PLATFORM_MEMORY
+	/* The firmware uses a static heap, the host the C library one */
+	mbedtls_platform_set_calloc_free(calloc, free);
+#endif
+
+	if ((mbedtls_md(mbedtls_md_info_from_type(MBEDTLS_MD_SHA256),
+			(const uint8_t *)"abc", 3U, whole) != 0) ||
+	    (memcmp(whole, sha256_abc, sizeof(sha256_abc)) != 0)) {
+		fprintf(stderr, "SHA-256 gives a wrong digest\n");
+		return 1;
+	}
+
+	data = xmalloc(data_size);
+	for (i = 0; i < data_size; i++)
+		data[i] = (uint8_t)(rand() >> 8);
+
+	printf("%zu KB of data, %zu KB chunks, %lu iterations\n",
+	       data_size / 1024U, chunk_size / 1024U, iterations);
+	printf("  %-8s %12s %12s\n", "", "one call", "in chunks");
+
+	for (i = 0; i < sizeof(algs) / sizeof(algs[0]); i++) {
+		info = mbedtls_md_info_from_type(algs[i]);
+		if (info == NULL)
+			continue;
+
+		whole_mbs = bench(info, data, whole, hash_whole);
+		chunks_mbs = bench(info, data, chunks, hash_chunks);
+		if (memcmp(whole, chunks, mbedtls_md_get_size(info)) != 0) {
+			fprintf(stderr, "%s digests differ\n",
+				mbedtls_md_get_name(info));
+			return 1;
+		}
+
+		printf("  %-8s %7.1f MB/s %7.1f MB/s\n",
+		       mbedtls_md_get_name(info), whole_mbs, chunks_mbs);
+	}
+
+	free(data);
+	return 0;
+}
@@ -0,0 +1,298 @@
+/*
+ * Copyright (c) 2020, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Correctness and throughput benchmark of the memcpy(), memset(), memmove()
+ * and memcmp() of lib/libc, built for the host as tf_memcpy() etc. They are
+ * checked against the host C library over random sizes, alignments and
+ * overlaps, and timed against it and against byte-at-a-time loops.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define BUF_SIZE	(1U << 20)
+#define CHECK_ROUNDS	200000U
+#define MIN_BENCH_BYTES	(32U << 20)
+
+void *tf_memcpy(void *dst, const void *src, size_t len);
+void *tf_memset(void *dst, int val, size_t count);
+void *tf_memmove(void *dst, const void *src, size_t len);
+int tf_memcmp(const void *s1, const void *s2, size_t len);
+
+/*
+ * Byte-at-a-time loops, as in lib/libc before word accesses were used. They
+ * are built with -fno-tree-loop-distribute-patterns so that the compiler
+ * doesn't turn them into calls to the host C library.
+ */
+static void *byte_memcpy(void *dst, const void *src, size_t len)
+{
+	const char *s = src;
+	char *d = dst;
+
+	while (len--)
+		*d++ = *s++;
+
+	return dst;
+}
+
+static void *byte_memset(void *dst, int val, size_t count)
+{
+	char *ptr = dst;
+
+	while (count--)
+		*ptr++ = (char)val;
+
+	return dst;
+}
+
+static int byte_memcmp(const void *s1, const void *s2, size_t len)
+{
+	const unsigned char *s = s1;
+	const unsigned char *d = s2;
+
+	for (; len != 0U; len--, s++, d++) {
+		if (*s != *d)
+			return *s - *d;
+	}
+
+	return 0;
+}
+
+typedef struct impl {
+	const char *name;
+	void *(*cpy)(void *dst, const void *src, size_t len);
+	void *(*set)(void *dst, int val, size_t count);
+	void *(*move)(void *dst, const void *src, size_t len);
+	int (*cmp)(const void *s1, const void *s2, size_t len);
+} impl_t;
+
+static const impl_t impls[] = {
+	{ "lib/libc", tf_memcpy, tf_memset, tf_memmove, tf_memcmp },
+	{ "host libc", memcpy, memset, memmove, memcmp },
+	{ "byte loop", byte_memcpy, byte_memset, byte_memcpy, byte_memcmp },
+};
+
+static uint8_t *buf_a, *buf_b, *buf_c;
+
+static void *xmalloc(size_t size)
+{
+	void *p = malloc(size);
+
+	if (p == NULL) {
+		fprintf(stderr, "Out of memory\n");
+		exit(1);
+	}
+
+	return p;
+}
+
+static double now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static int sign(int x)
+{
+	return (x > 0) - (x < 0);
+}
+
+static void fail(const char *func, size_t dst_off, size_t src_off, size_t len)
+{
+	fprintf(stderr, "%s wrong with dst+%zu, src+%zu, len %zu\n", func,
+		dst_off, src_off, len);
+	exit(1);
+}
+
+static void fill_random(uint8_t *buf, size_t len)
+{
+	static uint64_t state = 0x9e3779b97f4a7c15ULL;
+	size_t i;
+
+	/* xorshift64, much faster than rand() for whole buffers */
+	for (i = 0; i < len; i++) {
+		state ^= state << 13;
+		state ^= state >> 7;
+		state ^= state << 17;
+		buf[i] = (uint8_t)state;
+	}
+}
+
+/* Random length, mostly small, sometimes up to a few KB */
+static size_t random_len(void)
+{
+	return (rand() % 4 == 0) ? (size_t)(rand() % 4096) :
+				   (size_t)(rand() % 80);
+}
+
+/* Compare lib/libc with the host C library on random arguments */
+static void check(void)
+{
+	const size_t area = 8192U;
+	size_t i, dst_off, src_off, len;
+	int val;
+
+	for (i = 0; i < CHECK_ROUNDS; i++) {
+		len = random_len();
+		dst_off = (size_t)rand() % 64U;
+		src_off = (size_t)rand() % 64U;
+
+		/* memcpy() */
+		fill_random(buf_a, area);
+		memcpy(buf_b, buf_a, area);
+		if (tf_memcpy(buf_a + dst_off, buf_c + src_off, len) !=
+		    buf_a + dst_off)
+			fail("memcpy", dst_off, src_off, len);
+		memcpy(buf_b + dst_off, buf_c + src_off, len);
+		if (memcmp(buf_a, buf_b, area) != 0)
+			fail("memcpy", dst_off, src_off, len);
+
+		/* memset() */
+		val = rand() % 512 - 128;
+		if (tf_memset(buf_a + dst_off, val, len) != buf_a + dst_off)
+			fail("memset", dst_off, 0, len);
+		memset(buf_b + dst_off, val, len);
+		if (memcmp(buf_a, buf_b, area) != 0)
+			fail("memset", dst_off, 0, len);
+
+		/* memmove(), within the same buffer in both directions */
+		fill_random(buf_a, area);
+		memcpy(buf_b, buf_a, area);
+		src_off = dst_off + (size_t)rand() % 128U;
+		if (rand() % 2 == 0) {
+			size_t tmp = src_off;
+
+			src_off = dst_off;
+			dst_off = tmp;
+		}
+		if (tf_memmove(buf_a + dst_off, buf_a + src_off, len) !=
+		    buf_a + dst_off)
+			fail("memmove", dst_off, src_off, len);
+		memmove(buf_b + dst_off, buf_b + src_off, len);
+		if (memcmp(buf_a, buf_b, area) != 0)
+			fail("memmove", dst_off, src_off, len);
+
+		/* memcmp(), with at most one differing byte */
+		memcpy(buf_b + src_off, buf_a + dst_off, len);
+		if ((len != 0U) && (rand() % 2 == 0))
+			buf_b[src_off + (size_t)rand() % len] ^=
+				(uint8_t)(1 + rand() % 255);
+		if (sign(tf_memcmp(buf_a + dst_off, buf_b + src_off, len)) !=
+		    sign(memcmp(buf_a + dst_off, buf_b + src_off, len)))
+			fail("memcmp", dst_off, src_off, len);
+	}
+
+	printf("%u random calls of each function match the host C library\n",
+	       CHECK_ROUNDS);
+}
+
+/* Return the throughput in MB/s of 'op' on buffers of 'len' bytes */
+static double bench_op(const impl_t *impl, char op, size_t len, size_t off)
+{
+	size_t rounds = MIN_BENCH_BYTES / len, i;
+	volatile int sink = 0;
+	double start;
+
+	start = now_ns();
+	for (i = 0; i < rounds; i++) {
+		switch (op) {
+		case 'c':
+			impl->cpy(buf_a, buf_b + off, len);
+			break;
+		case 's':
+			impl->set(buf_a + off, (int)i, len);
+			break;
+		case 'm':
+			/* Overlapping, so that the copy is done backwards */
+			impl->move(buf_a + 8 + off, buf_a, len);
+			break;
+		default:
+			sink += impl->cmp(buf_b, (off == 0U) ? buf_a : buf_c + 1,
+					  len);
+			break;
+		}
+	}
+	(void)sink;
+
+	return (double)rounds * len * 1000 / (now_ns() - start);
+}
+
+static void bench(void)
+{
+	static const size_t lens[] = { 16, 64, 256, 4096, 65536, BUF_SIZE / 2 };
+	static const struct {
+		char op;
+		const char *name;
+	} ops[] = {
+		{ 'c', "memcpy" }, { 's', "memset" }, { 'm', "memmove" },
+		{ 'p', "memcmp" },
+	};
+	size_t i, j, k, off;
+
+	fill_random(buf_b, BUF_SIZE);
+
+	printf("\n%-8s %8s %6s", "MB/s", "bytes", "align");
+	for (k = 0; k < sizeof(impls) / sizeof(impls[0]); k++)
+		printf(" %10s", impls[k].name);
+	printf("\n");
+
+	for (i = 0; i < sizeof(ops) / sizeof(ops[0]); i++) {
+		/* Equal buffers, so that memcmp() compares all the bytes */
+		if (ops[i].op == 'p') {
+			memcpy(buf_a, buf_b, BUF_SIZE);
+			memcpy(buf_c + 1, buf_b, BUF_SIZE);
+		}
+
+		for (j = 0; j < sizeof(lens) / sizeof(lens[0]); j++) {
+			for (off = 0; off < 2U; off++) {
+				printf("%-8s %8zu %6s", ops[i].name, lens[j],
+				       (off == 0U) ? "same" : "+1");
+				for (k = 0; k < sizeof(impls) / sizeof(impls[0]);
+				     k++)
+					printf(" %10.0f",
+					       bench_op(&impls[k], ops[i].op,
+							lens[j], off));
+				printf("\n");
+			}
+		}
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	int opt;
+	int check_only = 0;
+
+	while ((opt = getopt(argc, argv, "c")) != -1) {
+		if (opt != 'c') {
+			printf("usage: libc_bench [-c]\n");
+			return 1;
+		}
+		check_only = 1;
+	}
+
+	/* Room for the offsets used by the checks and the benchmark */
+	buf_a = xmalloc(BUF_SIZE + 256U);
+	buf_b = xmalloc(BUF_SIZE + 256U);
+	buf_c = xmalloc(BUF_SIZE + 256U);
+	fill_random(buf_c, BUF_SIZE + 256U);
+
+	check();
+	if (check_only == 0)
+		bench();
+
+	free(buf_a);
+	free(buf_b);
+	free(buf_c);
+	return 0;
+}
@@ -0,0 +1,268 @@
+/*
+ * Copyright (c) 2020, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Benchmark of the memory passes done by load_image() in common/bl_common.c
+ * when it loads an image that is authenticated by its SHA-256 hash. An image
+ * is copied from a "storage" buffer, hashed and flushed out of the cache:
+ *
+ * - one step at a time over the whole image, as before images were loaded in
+ *   chunks;
+ * - one chunk at a time, hashing and flushing each chunk as soon as it has
+ *   been copied, as when the authentication module hashes images as they are
+ *   loaded;
+ * - in chunks, but hashing and flushing the whole image once it is loaded, as
+ *   when the authentication module can't hash images as they are loaded.
+ *
+ * Both buffers are flushed out of the cache before each load, as the image is
+ * not in the cache when BL2 reads it.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <openssl/evp.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#elif !defined(__aarch64__)
+#error "Unsupported host architecture"
+#endif
+
+#define CACHE_LINE_SIZE		64U
+#define SHA256_SIZE		32U
+
+static size_t image_size = 16U * 1024U * 1024U;
+static size_t chunk_size = 64U * 1024U;
+static unsigned long iterations = 20;
+
+/* Clean and invalidate a range of the data cache, like flush_dcache_range() */
+static void flush_range(const uint8_t *base, size_t size)
+{
+	uintptr_t addr = (uintptr_t)base & ~(uintptr_t)(CACHE_LINE_SIZE - 1U);
+
+	for (; addr < (uintptr_t)base + size; addr += CACHE_LINE_SIZE) {
+#ifdef __aarch64__
+		__asm__ volatile("dc civac, %0" : : "r" (addr) : "memory");
+#else
+		_mm_clflush((const void *)addr);
+#endif
+	}
+
+#ifdef __aarch64__
+	__asm__ volatile("dsb sy" : : : "memory");
+#else
+	_mm_mfence();
+#endif
+}
+
+static void *xmalloc(size_t size)
+{
+	void *p = malloc(size);
+
+	if (p == NULL) {
+		fprintf(stderr, "Out of memory\n");
+		exit(1);
+	}
+
+	return p;
+}
+
+static double now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static EVP_MD_CTX *hash_start(void)
+{
+	EVP_MD_CTX *ctx = EVP_MD_CTX_create();
+
+	if ((ctx == NULL) || (EVP_DigestInit_ex(ctx, EVP_sha256(), NULL) != 1)) {
+		fprintf(stderr, "Cannot initialize SHA-256\n");
+		exit(1);
+	}
+
+	return ctx;
+}
+
+static void hash_update(EVP_MD_CTX *ctx, const uint8_t *data, size_t len)
+{
+	if (EVP_DigestUpdate(ctx, data, len) != 1) {
+		fprintf(stderr, "Cannot hash the image\n");
+		exit(1);
+	}
+}
+
+static void hash_end(EVP_MD_CTX *ctx, uint8_t *hash)
+{
+	if (EVP_DigestFinal_ex(ctx, hash, NULL) != 1) {
+		fprintf(stderr, "Cannot hash the image\n");
+		exit(1);
+	}
+	EVP_MD_CTX_destroy(ctx);
+}
+
+/* Each load function loads 'src' to 'dst' and returns its hash in 'hash' */
+static void load_whole(uint8_t *dst, const uint8_t *src, uint8_t *hash)
+{
+	EVP_MD_CTX *ctx;
+
+	memcpy(dst, src, image_size);
+
+	ctx = hash_start();
+	hash_update(ctx, dst, image_size);
+	hash_end(ctx, hash);
+
+	flush_range(dst, image_size);
+}
+
+static void load_chunks_hashed(uint8_t *dst, const uint8_t *src,
+			       uint8_t *hash)
+{
+	EVP_MD_CTX *ctx = hash_start();
+	size_t offset, len;
+
+	for (offset = 0U; offset < image_size; offset += len) {
+		len = image_size - offset;
+		if (len > chunk_size)
+			len = chunk_size;
+
+		memcpy(dst + offset, src + offset, len);
+		hash_update(ctx, dst + offset, len);
+		flush_range(dst + offset, len);
+	}
+
+	hash_end(ctx, hash);
+}
+
+static void load_chunks(uint8_t *dst, const uint8_t *src, uint8_t *hash)
+{
+	EVP_MD_CTX *ctx;
+	size_t offset, len;
+
+	for (offset = 0U; offset < image_size; offset += len) {
+		len = image_size - offset;
+		if (len > chunk_size)
+			len = chunk_size;
+
+		memcpy(dst + offset, src + offset, len);
+	}
+
+	ctx = hash_start();
+	hash_update(ctx, dst, image_size);
+	hash_end(ctx, hash);
+
+	flush_range(dst, image_size);
+}
+
+static double bench(const char *what,
+		    void (*load)(uint8_t *dst, const uint8_t *src,
+				 uint8_t *hash),
+		    uint8_t *dst, const uint8_t *src, const uint8_t *ref_hash,
+		    double ref_ns)
+{
+	uint8_t hash[SHA256_SIZE];
+	double start, total = 0.0;
+	unsigned long i;
+
+	for (i = 0; i < iterations; i++) {
+		flush_range(src, image_size);
+		flush_range(dst, image_size);
+
+		start = now_ns();
+		load(dst, src, hash);
+		total += now_ns() - start;
+
+		if (memcmp(hash, ref_hash, SHA256_SIZE) != 0) {
+			fprintf(stderr, "%s: wrong hash\n", what);
+			exit(1);
+		}
+	}
+
+	total /= iterations;
+	printf("  %-28s %9.1f us  %7.1f MB/s", what, total / 1000,
+	       (double)image_size * 1000 / total);
+	if (ref_ns != 0.0)
+		printf("  x%.2f", ref_ns / total);
+	printf("\n");
+
+	return total;
+}
+
+static void usage(void)
+{
+	printf("usage: load_bench [-n ITERATIONS] [-s IMAGE_KB] [-c CHUNK_KB]\n");
+	exit(1);
+}
+
+static unsigned long parse_number(const char *arg)
+{
+	unsigned long val;
+	char *end;
+
+	val = strtoul(arg, &end, 0);
+	if ((*end != '\0') || (val == 0))
+		usage();
+
+	return val;
+}
+
+int main(int argc, char *argv[])
+{
+	uint8_t ref_hash[SHA256_SIZE];
+	uint8_t *src, *dst;
+	double whole_ns;
+	size_t i;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "n:s:c:")) != -1) {
+		switch (opt) {
+		case 'n':
+			iterations = parse_number(optarg);
+			break;
+		case 's':
+			image_size = parse_number(optarg) * 1024U;
+			break;
+		case 'c':
+			chunk_size = parse_number(optarg) * 1024U;
+			break;
+		default:
+			usage();
+		}
+	}
+
+	if (optind != argc)
+		usage();
+
+	src = xmalloc(image_size);
+	dst = xmalloc(image_size);
+
+	/* Touch both buffers so that page faults are not measured */
+	for (i = 0; i < image_size; i++)
+		src[i] = (uint8_t)(rand() >> 8);
+	memset(dst, 0, image_size);
+
+	load_whole(dst, src, ref_hash);
+
+	printf("%zu KB image, %zu KB chunks, %lu iterations\n",
+	       image_size / 1024U, chunk_size / 1024U, iterations);
+	whole_ns = bench("whole image", load_whole, dst, src, ref_hash, 0.0);
+	bench("chunks, hashed as loaded", load_chunks_hashed, dst, src,
+	      ref_hash, whole_ns);
+	bench("chunks, hashed once loaded", load_chunks, dst, src, ref_hash,
+	      whole_ns);
+
+	free(src);
+	free(dst);
+	return 0;
+}
@@ -0,0 +1,352 @@
+/*
+ * Copyright (c) 2020, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Multithreaded stress test and benchmark of the power domain state words used
+ * by PSCI_ATOMIC_COORDINATION, from lib/psci/psci_pd_state.h. Each thread
+ * models a CPU of a system made of clusters, which repeatedly powers down and
+ * back up. A power down and power up follows psci_do_state_coordination() and
+ * psci_acquire_pwr_domain_locks() with the state words, and the power domains
+ * are checked never to be turned off while a CPU in them is running nor to be
+ * seen off by a running CPU. The threads yield at random points of the cycle
+ * so that they also interleave on hosts with few CPUs. The same cycles are
+ * then timed without yielding, with the state words and with one lock per
+ * power domain, as without PSCI_ATOMIC_COORDINATION.
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "psci_pd_state.h"
+
+#define MAX_CLUSTERS		16U
+#define MAX_CLUSTER_CPUS	16U
+#define CACHE_LINE		64U
+
+/*
+ * One in KEEP_RUN_RATE last CPUs of a cluster models a platform which
+ * coordinates the cluster to RUN, so that it stays counted by the system.
+ */
+#define KEEP_RUN_RATE		8U
+
+/* Rates of yielding in the stress test, while owning a power domain or not */
+#define YIELD_RATE		4U
+#define OWNER_YIELD_RATE	64U
+
+typedef struct pd_state {
+	unsigned int word;
+	unsigned int on;
+	unsigned int running;
+	int lock;
+	bool req_off[MAX_CLUSTER_CPUS];
+} __attribute__((aligned(CACHE_LINE))) pd_state_t;
+
+typedef struct cpu {
+	pthread_t thread;
+	unsigned int idx;
+	unsigned int cluster;
+	uint32_t seed;
+} cpu_t;
+
+static unsigned int nr_clusters = 4;
+static unsigned int cluster_cpus = 4;
+static unsigned long iterations = 20000;
+
+static pd_state_t clusters[MAX_CLUSTERS];
+static pd_state_t sys;
+static cpu_t cpus[MAX_CLUSTERS * MAX_CLUSTER_CPUS];
+static pthread_barrier_t start_barrier;
+static bool use_locks;
+static bool stress;
+static unsigned long sys_off_count;
+
+static void check(bool cond, const char *what)
+{
+	if (!cond) {
+		fprintf(stderr, "Protocol error: %s\n", what);
+		exit(1);
+	}
+}
+
+static unsigned int load(const unsigned int *p)
+{
+	return __atomic_load_n(p, __ATOMIC_RELAXED);
+}
+
+static void store(unsigned int *p, unsigned int val)
+{
+	__atomic_store_n(p, val, __ATOMIC_RELAXED);
+}
+
+static uint32_t xorshift(uint32_t *seed)
+{
+	*seed ^= *seed << 13;
+	*seed ^= *seed >> 17;
+	*seed ^= *seed << 5;
+	return *seed;
+}
+
+static void maybe_yield(cpu_t *cpu, unsigned int rate)
+{
+	if (stress && ((xorshift(&cpu->seed) % rate) == 0U))
+		sched_yield();
+}
+
+static void atomic_cpu_down(cpu_t *cpu)
+{
+	pd_state_t *cl = &clusters[cpu->cluster];
+
+	(void)__atomic_fetch_sub(&cl->running, 1U, __ATOMIC_RELAXED);
+	(void)__atomic_fetch_sub(&sys.running, 1U, __ATOMIC_RELAXED);
+
+	if (psci_pd_state_leave(&cl->word, cpu->idx)) {
+		check(load(&cl->running) == 0U, "cluster off with CPUs on");
+		check(load(&cl->on) != 0U, "cluster turned off twice");
+		maybe_yield(cpu, OWNER_YIELD_RATE);
+
+		if ((xorshift(&cpu->seed) % KEEP_RUN_RATE) != 0U) {
+			store(&cl->on, 0U);
+
+			if (psci_pd_state_leave(&sys.word, cpu->idx)) {
+				check(load(&sys.running) == 0U,
+				      "system off with CPUs on");
+				check(load(&sys.on) != 0U,
+				      "system turned off twice");
+				store(&sys.on, 0U);
+				sys_off_count++;
+				maybe_yield(cpu, OWNER_YIELD_RATE);
+			}
+		}
+	}
+
+	psci_pd_state_release(&sys.word, cpu->idx);
+	psci_pd_state_release(&cl->word, cpu->idx);
+}
+
+static void atomic_cpu_up(cpu_t *cpu)
+{
+	pd_state_t *cl = &clusters[cpu->cluster];
+
+	if (psci_pd_state_enter(&cl->word, cpu->idx) && (load(&cl->on) == 0U)) {
+		if (psci_pd_state_enter(&sys.word, cpu->idx)) {
+			check(load(&sys.on) == 0U, "system turned on twice");
+			store(&sys.on, 1U);
+		}
+		store(&cl->on, 1U);
+		maybe_yield(cpu, OWNER_YIELD_RATE);
+	}
+
+	check((load(&cl->on) != 0U) && (load(&sys.on) != 0U),
+	      "CPU woke up in a power domain which is off");
+
+	psci_pd_state_release(&sys.word, cpu->idx);
+	psci_pd_state_release(&cl->word, cpu->idx);
+
+	(void)__atomic_fetch_add(&cl->running, 1U, __ATOMIC_RELAXED);
+	(void)__atomic_fetch_add(&sys.running, 1U, __ATOMIC_RELAXED);
+}
+
+static void lock(int *l)
+{
+	while (__atomic_exchange_n(l, 1, __ATOMIC_ACQUIRE) != 0) {
+		while (__atomic_load_n(l, __ATOMIC_RELAXED) != 0)
+			sched_yield();
+	}
+}
+
+static void unlock(int *l)
+{
+	__atomic_store_n(l, 0, __ATOMIC_RELEASE);
+}
+
+/*
+ * As without PSCI_ATOMIC_COORDINATION, the locks of all the power domains are
+ * taken, and each level is coordinated from the states requested by all the
+ * CPUs in it.
+ */
+static void lock_cpu_down(cpu_t *cpu)
+{
+	pd_state_t *cl = &clusters[cpu->cluster];
+	unsigned int c, i;
+	bool off = true;
+
+	lock(&cl->lock);
+	lock(&sys.lock);
+
+	cl->req_off[cpu->idx % cluster_cpus] = true;
+	for (i = 0U; i < cluster_cpus; i++)
+		off = off && cl->req_off[i];
+	cl->on = off ? 0U : 1U;
+
+	off = true;
+	for (c = 0U; c < nr_clusters; c++)
+		off = off && (clusters[c].on == 0U);
+	sys.on = off ? 0U : 1U;
+
+	unlock(&sys.lock);
+	unlock(&cl->lock);
+}
+
+static void lock_cpu_up(cpu_t *cpu)
+{
+	pd_state_t *cl = &clusters[cpu->cluster];
+
+	lock(&cl->lock);
+	lock(&sys.lock);
+
+	cl->req_off[cpu->idx % cluster_cpus] = false;
+	cl->on = 1U;
+	sys.on = 1U;
+
+	unlock(&sys.lock);
+	unlock(&cl->lock);
+}
+
+static void *cpu_thread(void *arg)
+{
+	void (*down)(cpu_t *cpu) = use_locks ? lock_cpu_down : atomic_cpu_down;
+	void (*up)(cpu_t *cpu) = use_locks ? lock_cpu_up : atomic_cpu_up;
+	cpu_t *cpu = arg;
+	unsigned long i;
+
+	pthread_barrier_wait(&start_barrier);
+
+	for (i = 0U; i < iterations; i++) {
+		down(cpu);
+		maybe_yield(cpu, YIELD_RATE);
+		up(cpu);
+		maybe_yield(cpu, YIELD_RATE);
+	}
+
+	return NULL;
+}
+
+static double now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static double run(bool locks, bool yield)
+{
+	unsigned int nr_cpus = nr_clusters * cluster_cpus;
+	unsigned int c, i;
+	double start;
+
+	for (c = 0U; c < nr_clusters; c++) {
+		clusters[c] = (pd_state_t) {
+			.word = cluster_cpus,
+			.on = 1U,
+			.running = cluster_cpus,
+		};
+	}
+	sys = (pd_state_t) {
+		.word = nr_clusters,
+		.on = 1U,
+		.running = nr_cpus,
+	};
+	use_locks = locks;
+	stress = yield;
+
+	pthread_barrier_init(&start_barrier, NULL, nr_cpus + 1U);
+
+	for (i = 0U; i < nr_cpus; i++) {
+		cpus[i].idx = i;
+		cpus[i].cluster = i / cluster_cpus;
+		cpus[i].seed = i + 1U;
+		if (pthread_create(&cpus[i].thread, NULL, cpu_thread,
+				   &cpus[i]) != 0) {
+			fprintf(stderr, "Failed to create thread\n");
+			exit(1);
+		}
+	}
+
+	pthread_barrier_wait(&start_barrier);
+	start = now_ns();
+
+	for (i = 0U; i < nr_cpus; i++)
+		pthread_join(cpus[i].thread, NULL);
+
+	pthread_barrier_destroy(&start_barrier);
+
+	return (now_ns() - start) / ((double)iterations * nr_cpus);
+}
+
+static void usage(void)
+{
+	printf("usage: psci_bench [-c CLUSTERS] [-n CPUS_PER_CLUSTER] [-i ITERATIONS]\n");
+	exit(1);
+}
+
+static unsigned long parse_number(const char *arg, unsigned long max)
+{
+	unsigned long val;
+	char *end;
+
+	val = strtoul(arg, &end, 0);
+	if ((*end != '\0') || (val == 0) || (val > max))
+		usage();
+
+	return val;
+}
+
+int main(int argc, char *argv[])
+{
+	double atomic_ns, lock_ns;
+	unsigned int c;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "c:n:i:")) != -1) {
+		switch (opt) {
+		case 'c':
+			nr_clusters = parse_number(optarg, MAX_CLUSTERS);
+			break;
+		case 'n':
+			cluster_cpus = parse_number(optarg, MAX_CLUSTER_CPUS);
+			break;
+		case 'i':
+			iterations = parse_number(optarg, ~0UL);
+			break;
+		default:
+			usage();
+		}
+	}
+
+	if (optind != argc)
+		usage();
+
+	(void)run(false, true);
+
+	/* Every CPU is running again, so every power domain must be on */
+	for (c = 0U; c < nr_clusters; c++) {
+		check((clusters[c].word == cluster_cpus) && (clusters[c].on != 0U),
+		      "cluster state word out of sync");
+	}
+	check((sys.word == nr_clusters) && (sys.on != 0U),
+	      "system state word out of sync");
+
+	printf("%u clusters of %u CPUs, %lu power down/up cycles per CPU\n",
+	       nr_clusters, cluster_cpus, iterations);
+	printf("State words: protocol checks passed, system turned off %lu times\n",
+	       sys_off_count);
+
+	atomic_ns = run(false, false);
+	lock_ns = run(true, false);
+
+	printf("%-16s %10s\n", "Coordination", "ns/cycle");
+	printf("%-16s %10.1f\n", "state words", atomic_ns);
+	printf("%-16s %10.1f\n", "locks", lock_ns);
+
+	return 0;
+}
@@ -0,0 +1,35 @@
+/*
+ * Copyright (c) 2020, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Host replacement of include/arch/aarch64/arch_features.h for the translation
+ * table library. Whether the ARMv8.4-TLBI range instructions are present is
+ * chosen by the benchmark.
+ */
+
+#ifndef ARCH_FEATURES_H
+#define ARCH_FEATURES_H
+
+#include <stdbool.h>
+
+extern bool bench_tlbi_range;
+
+static inline bool is_armv8_2_ttcnp_present(void)
+{
+	return false;
+}
+
+static inline bool is_armv8_4_ttst_present(void)
+{
+	return false;
+}
+
+static inline bool is_armv8_4_tlbi_range_present(void)
+{
+	return bench_tlbi_range;
+}
+
+#endif /* ARCH_FEATURES_H */
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2020, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Host replacement of include/arch/aarch64/arch_helpers.h for the translation
+ * table library. The tables are never used by an MMU, so the barriers and TLB
+ * maintenance instructions are only counted. The system registers read as if
+ * running at EL3 with the MMU and the caches off.
+ */
+
+#ifndef ARCH_HELPERS_H
+#define ARCH_HELPERS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <arch.h>
+
+extern unsigned long bench_dsb_count;
+extern unsigned long bench_tlbi_count;
+
+static inline void dsbish(void)
+{
+	bench_dsb_count++;
+}
+
+static inline void dsbishst(void)
+{
+	bench_dsb_count++;
+}
+
+static inline void isb(void)
+{
+}
+
+#define DEFINE_BENCH_TLBIOP_FUNC(_op)				\
+static inline void tlbi ## _op(void)				\
+{								\
+	bench_tlbi_count++;					\
+}
+
+#define DEFINE_BENCH_TLBIOP_PARAM_FUNC(_op)			\
+static inline void tlbi ## _op(uint64_t v)			\
+{								\
+	(void)v;						\
+	bench_tlbi_count++;					\
+}
+
+DEFINE_BENCH_TLBIOP_FUNC(vmalle1is)
+DEFINE_BENCH_TLBIOP_FUNC(alle2is)
+DEFINE_BENCH_TLBIOP_FUNC(alle3is)
+DEFINE_BENCH_TLBIOP_PARAM_FUNC(vaae1is)
+DEFINE_BENCH_TLBIOP_PARAM_FUNC(vae2is)
+DEFINE_BENCH_TLBIOP_PARAM_FUNC(vae3is)
+DEFINE_BENCH_TLBIOP_PARAM_FUNC(rvaae1is)
+DEFINE_BENCH_TLBIOP_PARAM_FUNC(rvae2is)
+DEFINE_BENCH_TLBIOP_PARAM_FUNC(rvae3is)
+
+static inline uint64_t read_CurrentEl(void)
+{
+	return MODE_EL3 << MODE_EL_SHIFT;
+}
+
+static inline uint64_t read_sctlr_el1(void)
+{
+	return 0U;
+}
+
+static inline uint64_t read_sctlr_el2(void)
+{
+	return 0U;
+}
+
+static inline uint64_t read_sctlr_el3(void)
+{
+	return 0U;
+}
+
+/* 4KB granule supported, 48-bit physical addresses (PARange 0b0101) */
+static inline uint64_t read_id_aa64mmfr0_el1(void)
+{
+	return 0x5U;
+}
+
+void clean_dcache_range(uintptr_t addr, size_t size);
+
+#endif /* ARCH_HELPERS_H */
@@ -0,0 +1,18 @@
+/*
+ * Copyright (c) 2020, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/* Host replacement of include/common/bl_common.h for the translation table library */
+
+#ifndef BL_COMMON_H
+#define BL_COMMON_H
+
+#include <lib/utils_def.h>
+
+/* The benchmark doesn't run from the memory mapped by its translation tables */
+#define BL_CODE_BASE			U(0)
+#define BL_CODE_END			U(0)
+
+#endif /* BL_COMMON_H */
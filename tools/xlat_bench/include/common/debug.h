@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) 2020, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/* Host replacement of include/common/debug.h for the translation table library */
+
+#ifndef DEBUG_H
+#define DEBUG_H
+
+#include <stdio.h>
+
+#define LOG_LEVEL_NONE			0
+#define LOG_LEVEL_ERROR			10
+#define LOG_LEVEL_NOTICE		20
+#define LOG_LEVEL_WARNING		30
+#define LOG_LEVEL_INFO			40
+#define LOG_LEVEL_VERBOSE		50
+
+#ifndef LOG_LEVEL
+#define LOG_LEVEL			LOG_LEVEL_WARNING
+#endif
+
+#define ERROR(...)	printf("ERROR:   " __VA_ARGS__)
+#define WARN(...)	printf("WARNING: " __VA_ARGS__)
+#define NOTICE(...)
+#define INFO(...)
+#define VERBOSE(...)
+
+void panic(void) __attribute__((noreturn));
+
+#endif /* DEBUG_H */
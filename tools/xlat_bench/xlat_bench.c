@@ -0,0 +1,334 @@
+/*
+ * Copyright (c) 2020, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Benchmark of the translation table library of lib/xlat_tables_v2, built for
+ * the host. Hundreds of one page regions are first mapped into a context in
+ * random order and unmapped in another random order, which shows how the cost
+ * of each operation grows with the number of regions in the context.
+ *
+ * Then the memory attributes of page mapped regions of several sizes are
+ * changed, and the regions unmapped. The tables are only written to memory and
+ * the barriers and TLB maintenance instructions are counted instead of being
+ * executed, with and without ARMv8.4-TLBI range instructions, as their cost
+ * depends on the hardware.
+ *
+ * Last, the attributes of one page of a block mapped region are changed and
+ * restored, which splits the block into tables and coalesces them back.
+ */
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <arch_features.h>
+#include <arch_helpers.h>
+#include <lib/xlat_tables/xlat_tables_v2.h>
+
+#include "xlat_tables_private.h"
+
+#define MAX_REGIONS		1024U
+#define BENCH_TABLES		16U
+#define WINDOW_BASE		0x40000000UL
+
+static const unsigned int region_counts[] = { 100U, 200U, 400U, 800U };
+static const unsigned int page_counts[] = { 16U, 128U, 512U, 2048U };
+static unsigned long iterations = 20;
+
+REGISTER_XLAT_CONTEXT2(bench, MAX_REGIONS + 1U, BENCH_TABLES,
+		       PLAT_VIRT_ADDR_SPACE_SIZE, PLAT_PHY_ADDR_SPACE_SIZE,
+		       EL3_REGIME, "xlat_table");
+
+unsigned long bench_dsb_count;
+unsigned long bench_tlbi_count;
+bool bench_tlbi_range;
+
+void clean_dcache_range(uintptr_t addr, size_t size)
+{
+}
+
+void panic(void)
+{
+	fprintf(stderr, "Translation table library panic\n");
+	exit(1);
+}
+
+static double now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static void shuffle(unsigned int *pages, unsigned int count)
+{
+	unsigned int i, j, tmp;
+
+	for (i = count - 1U; i > 0U; i--) {
+		j = (unsigned int)rand() % (i + 1U);
+		tmp = pages[i];
+		pages[i] = pages[j];
+		pages[j] = tmp;
+	}
+}
+
+static mmap_region_t page_region(unsigned int page)
+{
+	uintptr_t va = WINDOW_BASE + ((uintptr_t)page * PAGE_SIZE);
+
+	return (mmap_region_t)MAP_REGION_FLAT(va, PAGE_SIZE,
+					      MT_DEVICE | MT_RW | MT_SECURE);
+}
+
+static void check(int ret, int expected, const char *what)
+{
+	if (ret != expected) {
+		fprintf(stderr, "%s returned %d instead of %d\n", what, ret,
+			expected);
+		exit(1);
+	}
+}
+
+static void bench_regions(unsigned int count)
+{
+	/* Twice as many pages as regions, so that the regions are scattered */
+	unsigned int window = 2U * count;
+	unsigned int *pages = malloc(window * sizeof(*pages));
+	double start, add_ns = 0.0, remove_ns = 0.0;
+	mmap_region_t mm;
+	unsigned long it;
+	unsigned int i;
+
+	if (pages == NULL) {
+		fprintf(stderr, "Out of memory\n");
+		exit(1);
+	}
+
+	for (i = 0U; i < window; i++)
+		pages[i] = i;
+
+	for (it = 0U; it < iterations; it++) {
+		shuffle(pages, window);
+		start = now_ns();
+		for (i = 0U; i < count; i++) {
+			mm = page_region(pages[i]);
+			check(mmap_add_dynamic_region_ctx(&bench_xlat_ctx, &mm),
+			      0, "mmap_add_dynamic_region_ctx()");
+		}
+		add_ns += now_ns() - start;
+
+		/* A partial overlap must still be detected */
+		mm = page_region(pages[0]);
+		mm.size *= 2U;
+		mm.base_va -= PAGE_SIZE;
+		mm.base_pa -= PAGE_SIZE;
+		check(mmap_add_dynamic_region_ctx(&bench_xlat_ctx, &mm),
+		      -EPERM, "Overlapping mmap_add_dynamic_region_ctx()");
+
+		shuffle(pages, count);
+		start = now_ns();
+		for (i = 0U; i < count; i++) {
+			mm = page_region(pages[i]);
+			check(mmap_remove_dynamic_region_ctx(&bench_xlat_ctx,
+					mm.base_va, mm.size),
+			      0, "mmap_remove_dynamic_region_ctx()");
+		}
+		remove_ns += now_ns() - start;
+	}
+
+	printf("%8u %12.1f %12.1f\n", count,
+	       add_ns / ((double)iterations * count),
+	       remove_ns / ((double)iterations * count));
+
+	free(pages);
+}
+
+static void bench_maintenance(unsigned int pages, bool tlbi_range)
+{
+	mmap_region_t mm = MAP_REGION2(WINDOW_BASE, WINDOW_BASE,
+				       (size_t)pages * PAGE_SIZE,
+				       MT_MEMORY | MT_RW | MT_SECURE |
+				       MT_EXECUTE_NEVER, PAGE_SIZE);
+	unsigned long attr_dsb = 0U, attr_tlbi = 0U;
+	unsigned long remove_dsb = 0U, remove_tlbi = 0U;
+	double start, attr_ns = 0.0;
+	unsigned long it;
+
+	bench_tlbi_range = tlbi_range;
+
+	for (it = 0U; it < iterations; it++) {
+		check(mmap_add_dynamic_region_ctx(&bench_xlat_ctx, &mm), 0,
+		      "mmap_add_dynamic_region_ctx()");
+
+		bench_dsb_count = 0U;
+		bench_tlbi_count = 0U;
+		start = now_ns();
+		check(xlat_change_mem_attributes_ctx(&bench_xlat_ctx,
+				mm.base_va, mm.size,
+				MT_RO | MT_EXECUTE_NEVER),
+		      0, "xlat_change_mem_attributes_ctx()");
+		check(xlat_change_mem_attributes_ctx(&bench_xlat_ctx,
+				mm.base_va, mm.size,
+				MT_RW | MT_EXECUTE_NEVER),
+		      0, "xlat_change_mem_attributes_ctx()");
+		attr_ns += now_ns() - start;
+		attr_dsb += bench_dsb_count;
+		attr_tlbi += bench_tlbi_count;
+
+		bench_dsb_count = 0U;
+		bench_tlbi_count = 0U;
+		check(mmap_remove_dynamic_region_ctx(&bench_xlat_ctx,
+				mm.base_va, mm.size),
+		      0, "mmap_remove_dynamic_region_ctx()");
+		remove_dsb += bench_dsb_count;
+		remove_tlbi += bench_tlbi_count;
+	}
+
+	/* Each iteration changes the attributes twice */
+	printf("%8u %6s %12.1f %8lu %8lu %10lu %8lu\n", pages,
+	       tlbi_range ? "yes" : "no",
+	       attr_ns / (2.0 * (double)iterations),
+	       attr_dsb / (2U * iterations), attr_tlbi / (2U * iterations),
+	       remove_dsb / iterations, remove_tlbi / iterations);
+}
+
+static unsigned int used_tables(void)
+{
+	unsigned int i, used = 0U;
+
+	for (i = 0U; i < bench_xlat_ctx.tables_num; i++) {
+		if (bench_xlat_ctx.tables_mapped_regions[i] != 0)
+			used++;
+	}
+
+	return used;
+}
+
+static void check_page_attr(uintptr_t va, uint32_t expected)
+{
+	uint32_t attr;
+
+	check(xlat_get_mem_attributes_ctx(&bench_xlat_ctx, va, &attr), 0,
+	      "xlat_get_mem_attributes_ctx()");
+	if ((attr & MT_RW) != (expected & MT_RW)) {
+		fprintf(stderr, "Wrong attributes 0x%x at 0x%lx\n", attr,
+			(unsigned long)va);
+		exit(1);
+	}
+}
+
+static void bench_split(size_t block_size)
+{
+	mmap_region_t mm = MAP_REGION_FLAT(WINDOW_BASE, block_size,
+					   MT_MEMORY | MT_RW | MT_SECURE |
+					   MT_EXECUTE_NEVER);
+	uintptr_t page_va = WINDOW_BASE + (block_size / 2U);
+	unsigned long dsb = 0U, tlbi = 0U;
+	unsigned int tables, split_tables = 0U;
+	double start, split_ns = 0.0;
+	unsigned long it;
+
+	bench_tlbi_range = false;
+	check(mmap_add_dynamic_region_ctx(&bench_xlat_ctx, &mm), 0,
+	      "mmap_add_dynamic_region_ctx()");
+	tables = used_tables();
+
+	for (it = 0U; it < iterations; it++) {
+		bench_dsb_count = 0U;
+		bench_tlbi_count = 0U;
+		start = now_ns();
+		check(xlat_change_mem_attributes_ctx(&bench_xlat_ctx, page_va,
+				PAGE_SIZE, MT_RO | MT_EXECUTE_NEVER),
+		      0, "xlat_change_mem_attributes_ctx()");
+		split_ns += now_ns() - start;
+		split_tables = used_tables() - tables;
+		check_page_attr(page_va, MT_RO);
+		check_page_attr(page_va + PAGE_SIZE, MT_RW);
+
+		start = now_ns();
+		check(xlat_change_mem_attributes_ctx(&bench_xlat_ctx, page_va,
+				PAGE_SIZE, MT_RW | MT_EXECUTE_NEVER),
+		      0, "xlat_change_mem_attributes_ctx()");
+		split_ns += now_ns() - start;
+		dsb += bench_dsb_count;
+		tlbi += bench_tlbi_count;
+		check_page_attr(page_va, MT_RW);
+
+		/* The tables of the split must all be back to blocks */
+		if (used_tables() != tables) {
+			fprintf(stderr, "Block of 0x%zx bytes not coalesced\n",
+				block_size);
+			exit(1);
+		}
+	}
+
+	check(mmap_remove_dynamic_region_ctx(&bench_xlat_ctx, mm.base_va,
+					     mm.size),
+	      0, "mmap_remove_dynamic_region_ctx()");
+
+	printf("%8zu %8u %14.1f %8lu %8lu\n", block_size >> 20, split_tables,
+	       split_ns / (double)iterations, dsb / iterations,
+	       tlbi / iterations);
+}
+
+static void usage(void)
+{
+	printf("usage: xlat_bench [-n ITERATIONS]\n");
+	exit(1);
+}
+
+int main(int argc, char *argv[])
+{
+	/* A static region below the window, as a firmware image would have */
+	mmap_region_t image = MAP_REGION_FLAT(WINDOW_BASE - (16U * PAGE_SIZE),
+					      16U * PAGE_SIZE,
+					      MT_MEMORY | MT_RW | MT_SECURE);
+	unsigned int i;
+	char *end;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "n:")) != -1) {
+		switch (opt) {
+		case 'n':
+			iterations = strtoul(optarg, &end, 0);
+			if ((*end != '\0') || (iterations == 0U))
+				usage();
+			break;
+		default:
+			usage();
+		}
+	}
+
+	if (optind != argc)
+		usage();
+
+	mmap_add_region_ctx(&bench_xlat_ctx, &image);
+	init_xlat_tables_ctx(&bench_xlat_ctx);
+
+	printf("%8s %12s %12s\n", "Regions", "Add (ns)", "Remove (ns)");
+	for (i = 0U; i < (sizeof(region_counts) / sizeof(region_counts[0]));
+	     i++)
+		bench_regions(region_counts[i]);
+
+	printf("\n%8s %6s %12s %8s %8s %10s %8s\n", "Pages", "Range",
+	       "Attrs (ns)", "DSBs", "TLBIs", "Unmap DSBs", "TLBIs");
+	for (i = 0U; i < (sizeof(page_counts) / sizeof(page_counts[0])); i++) {
+		bench_maintenance(page_counts[i], false);
+		bench_maintenance(page_counts[i], true);
+	}
+
+	printf("\n%8s %8s %14s %8s %8s\n", "Block MB", "Tables",
+	       "Split+coalesce", "DSBs", "TLBIs");
+	bench_split(XLAT_BLOCK_SIZE(2U));
+	bench_split(XLAT_BLOCK_SIZE(1U));
+
+	return 0;
+}